@@ -69,12 +69,13 @@ int ElbowMethod<PT, PD, M>::findK() {
         (this->m_kMeans).setNumClusters(static_cast<std::size_t>(k));
         (this->m_kMeans).fit();
         points = (this->m_kMeans).getPoints();
+        const std::vector<int32_t>& assignments = (this->m_kMeans).getAssignments();
         double sum = 0; 
 
         #pragma omp parallel for reduction(+:sum)
         for (size_t i = 0; i < points.size(); ++i) {
-            Point<PT, PD> centroidTmp = *(points[i].centroid);
-            sum += std::pow(EuclideanMetric<PT, PD>::distanceTo(points[i], centroidTmp), 2);
+            const CentroidPoint<PT, PD>& centroidTmp = pointerCentroids[assignments[i]];
+            sum += EuclideanMetric<PT, PD>::squaredDistance(points[i], centroidTmp);
         }
 
         std::cout << "K: " << k << ", WCSS: " << sum << std::endl;
@@ -25,7 +25,8 @@ public:
     {
         EUCLIDEAN,
         DIJKSTRA,
-        HEAT
+        HEAT,
+        VORONOI
     };
 
     static std::string toString(KInit kInit)
@@ -70,6 +71,8 @@ public:
             return "Euclidean";
         case MetricMethod::HEAT:
             return "Geodesic";
+        case MetricMethod::VORONOI:
+            return "Voronoi";
         default:
             return "Unknown Metric Method";
         }
@@ -91,6 +91,7 @@ double SilhouetteMethod<PT, PD, M>::computeSilhouetteScore(int k)
     (this->m_kMeans).fit();
 
     points = (this->m_kMeans).getPoints();
+    const std::vector<int32_t> &assignments = (this->m_kMeans).getAssignments();
 
     double totalScore = 0.0;
     int numPoints = points.size();
@@ -110,7 +111,7 @@ double SilhouetteMethod<PT, PD, M>::computeSilhouetteScore(int k)
         // Compute a(i): the average distance from point i to all other points in the same cluster
         for (int j = 0; j < numPoints; ++j)
         {
-            if (i != j && *(points[j].centroid) == *(points[i].centroid))
+            if (i != j && assignments[j] == assignments[i])
             {
                 a += EuclideanMetric<PT, PD>::distanceTo(points[j], points[i]);
                 countA++;
@@ -122,7 +123,7 @@ double SilhouetteMethod<PT, PD, M>::computeSilhouetteScore(int k)
         // Compute c(i): the average distance from point i to the closest cluster centroid
         for (int j = 0; j < pointerCentroids.size(); ++j)
         {
-            if (pointerCentroids[j] != *(points[i].centroid))
+            if (j != assignments[i])
             {
                 c += EuclideanMetric<PT, PD>::distanceTo(pointerCentroids[j], points[i]);
                 countC++;
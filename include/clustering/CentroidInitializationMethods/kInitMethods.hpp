@@ -6,7 +6,9 @@
 #include "geometry/metrics/Metric.hpp"
 #include "geometry/metrics/GeodesicDijkstraMetric.hpp"
 #include "geometry/metrics/GeodesicHeatMetric.hpp"
+#include "geometry/metrics/GeodesicVoronoiMetric.hpp"
 #include "geometry/metrics/EuclideanMetric.hpp"
+#include "geometry/metrics/MiniBatchEuclideanMetric.hpp"
 
 template <typename PT, std::size_t PD, class M>
 class KMeans;
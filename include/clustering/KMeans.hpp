@@ -89,6 +89,20 @@ public:
      */
     std::vector<Point<PT, PD>>& getPoints();
 
+    /** 
+     * \brief Getter for the structure-of-arrays view of the data points.
+     * 
+     * \return A reference to the point set, the labels hold the assigned centroid indices.
+     */
+    PointSet<PT, PD>& getPointSet();
+
+    /** 
+     * \brief Getter for the cluster assignment of the data points.
+     * 
+     * \return A reference to the vector holding the centroid index of each point.
+     */
+    const std::vector<int32_t>& getAssignments() const;
+
     /** 
      * \brief Getter for the centroids of the clusters.
      * 
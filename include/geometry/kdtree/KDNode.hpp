@@ -3,24 +3,28 @@
 
 #include <vector>
 #include <array>
-#include <memory>
+#include <cstdint>
 #include "geometry/point/Point.hpp"
-#include "geometry/point/HasWgtCent.hpp"
 
 /**
  * \class KdNode
- * \brief Represents a node in a kd-tree, including its bounding box and child pointers.
+ * \brief Represents a node in a kd-tree, including its bounding box and child indices.
  * 
  * A kd-tree (k-dimensional tree) is a space-partitioning data structure used 
  * for organizing points in a k-dimensional space. Each node represents a 
- * partitioning of space with a bounding box and may contain a single point 
- * (in leaf nodes).
+ * partitioning of space with a bounding box and the sum of the coordinates of
+ * the points it contains.
+ * 
+ * The nodes of a `KdTree` are stored in one contiguous buffer: the children are
+ * addressed by their position in that buffer and the points of the node are the
+ * range `[begin, end)` of the index permutation owned by the tree. The node has
+ * no virtual methods, so it is a plain aggregate of arrays and integers.
  * 
  * \tparam PT Type of the point coordinates.
  * \tparam PD Dimensionality of the points.
  */
 template <typename PT, std::size_t PD>
-class KdNode : public HasWgtCent<PT, PD> {
+class KdNode {
 public:
     /**
      * \brief Minimum coordinates of the node's bounding box.
@@ -37,27 +41,34 @@ public:
     std::array<PT, PD> cellMax;
 
     /**
-     * \brief Pointer to the left child node.
-     * 
-     * If this node is not a leaf, it has a left child representing 
-     * one of the partitions.
+     * \brief Sum of the coordinates of the points contained in the node.
      */
-    std::unique_ptr<KdNode<PT, PD>> left = nullptr;
+    std::array<PT, PD> wgtCent;
 
     /**
-     * \brief Pointer to the right child node.
-     * 
-     * If this node is not a leaf, it has a right child representing 
-     * the other partition.
+     * \brief Number of points contained in the node.
      */
-    std::unique_ptr<KdNode<PT, PD>> right = nullptr;
+    int count = 0;
 
     /**
-     * \brief Pointer to the single point of this node (only for leaf nodes).
-     * 
-     * If this node is a leaf, it stores a pointer to the associated point.
+     * \brief Index of the left child in the node buffer, or -1 for a leaf.
+     */
+    int32_t left = -1;
+
+    /**
+     * \brief Index of the right child in the node buffer, or -1 for a leaf.
      */
-    std::unique_ptr<Point<PT, PD>> myPoint = nullptr;
+    int32_t right = -1;
+
+    /**
+     * \brief First position of the node's points in the index permutation of the tree.
+     */
+    int32_t begin = 0;
+
+    /**
+     * \brief One past the last position of the node's points in the index permutation of the tree.
+     */
+    int32_t end = 0;
 
     /**
      * @brief Default constructor.
@@ -77,11 +88,9 @@ public:
     KdNode(const std::array<PT, PD>& min, const std::array<PT, PD>& max);
 
     /**
-     * \brief Virtual destructor.
-     * 
-     * Ensures proper cleanup of dynamically allocated child nodes.
+     * \brief Returns true if the node has no children.
      */
-    virtual ~KdNode() override;
+    bool isLeaf() const { return left < 0; }
 };
 
 #endif // KDNODE_HPP
@@ -2,12 +2,16 @@
 #define KDTREE_HPP
 
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <memory>
 #include <limits>
+#include <map>
+#include <cstdint>
 #include <omp.h>
 
 #include "geometry/kdtree/KDNode.hpp"
+#include "geometry/point/PointSet.hpp"
 
 /**
  * \class KdTree
@@ -22,56 +26,167 @@
 template <typename PT, std::size_t PD>
 class KdTree {
 public:
+    /**
+     * \brief Default maximum number of points stored in a leaf.
+     * 
+     * Buckets of a few tens of points remove the last levels of the tree, where the
+     * pruning test costs more than a brute-force assignment of the bucket.
+     */
+    static constexpr std::size_t DEFAULT_BUCKET_SIZE = 32;
+
+    /**
+     * \brief Smallest number of points of a subtree built by a separate task.
+     */
+    static constexpr std::size_t TASK_MIN_POINTS = std::size_t(1) << 12;
+
+    /**
+     * \brief Smallest number of points of a range whose median is selected with a parallel partition.
+     * 
+     * Below this size `std::nth_element` is faster than distributing the partition among threads.
+     */
+    static constexpr std::size_t PARALLEL_SELECT_MIN_POINTS = std::size_t(1) << 16;
+
     /**
      * \brief Constructs a KD-tree from a given set of points.
      * 
      * This constructor initializes the tree by recursively partitioning the input points.
      * 
      * \param points A reference to a vector of points to be organized into the tree.
+     * \param bucketSize Maximum number of points stored in a leaf.
+     */
+    KdTree(std::vector<Point<PT, PD>>& points, std::size_t bucketSize = DEFAULT_BUCKET_SIZE);
+
+    /**
+     * \brief Constructs a KD-tree from a structure-of-arrays point set.
+     * 
+     * The points are not reordered: the tree partitions a permutation of their indices
+     * and every node references a contiguous range of that permutation.
+     * 
+     * \param points The point set to be organized into the tree.
+     * \param bucketSize Maximum number of points stored in a leaf.
      */
-    KdTree(std::vector<Point<PT, PD>>& points);
+    KdTree(const PointSet<PT, PD>& points, std::size_t bucketSize = DEFAULT_BUCKET_SIZE);
 
     /**
      * \brief Destructor.
      * 
-     * Ensures proper cleanup of dynamically allocated nodes when the KdTree object is destroyed.
+     * Releases the node buffer and the index permutation.
      */
     ~KdTree();
 
     /**
-     * \brief Returns a reference to the root node of the kd-tree.
+     * \brief Returns the root node of the kd-tree.
      * 
      * The root node provides access to the entire tree structure.
      * 
-     * \return A unique pointer to the root KdNode.
+     * \return A pointer to the root KdNode, or nullptr if the tree is empty.
+     */
+    const KdNode<PT, PD>* getRoot() const;
+
+    /**
+     * \brief Finds the point of the tree closest to a query point.
+     * 
+     * Descends into the child on the side of the query first and skips the nodes whose
+     * bounding box is farther than the best point found so far, so a query visits
+     * O(log N) nodes on well spread points.
+     * 
+     * \param query The coordinates of the query point.
+     * \return The index of the closest point in the point set the tree was built from,
+     * the lowest one on ties, or -1 if the tree is empty.
+     */
+    int32_t nearest(const std::array<PT, PD>& query) const;
+
+    /**
+     * \brief Returns the node stored at a given position of the node buffer.
+     * 
+     * \param index The position of the node, e.g. the `left` or `right` field of its parent.
+     * \return A reference to the node.
+     */
+    const KdNode<PT, PD>& getNode(int32_t index) const { return nodes[index]; }
+
+    /**
+     * \brief Returns the contiguous buffer holding all the nodes, the root is at position 0.
+     */
+    const std::vector<KdNode<PT, PD>>& getNodes() const { return nodes; }
+
+    /**
+     * \brief Returns the permutation of the point indices partitioned by the tree.
+     * 
+     * The points of a node are `getIndices()[node.begin]` to `getIndices()[node.end - 1]`.
+     */
+    const std::vector<int32_t>& getIndices() const { return indices; }
+
+    /**
+     * \brief Returns the coordinate `dim` of every point, in the order of the index permutation.
+     * 
+     * The points of a node are the range `[node.begin, node.end)` of this array, so the
+     * coordinates of a leaf bucket are contiguous and can be streamed by a SIMD kernel.
+     * 
+     * \param dim The dimension to access.
+     * \return A pointer to `getIndices().size()` coordinates.
+     */
+    const PT* getCoordinates(std::size_t dim) const { return coordinates[dim].data(); }
+
+    /**
+     * \brief Returns the maximum number of points stored in a leaf.
      */
-    std::unique_ptr<KdNode<PT, PD>>& getRoot();
+    std::size_t getBucketSize() const { return bucketSize; }
 
 private:
-    std::unique_ptr<KdNode<PT, PD>> root = nullptr; ///< Root node of the KD-tree.
+    std::vector<KdNode<PT, PD>> nodes;            ///< Nodes of the KD-tree in pre-order, the root is the first one.
+    std::vector<int32_t> indices;                 ///< Permutation of the point indices, each node owns a contiguous range.
+    std::array<std::vector<PT>, PD> coordinates;  ///< Coordinates of the points in the order of the index permutation.
+    std::size_t bucketSize = DEFAULT_BUCKET_SIZE; ///< Maximum number of points stored in a leaf.
+    std::map<std::size_t, std::size_t> subtreeSizes; ///< Number of nodes of a subtree built over a given number of points (only during the build).
+    std::vector<int32_t> scratch;                 ///< Destination of the parallel partitions (only during the build).
+
+    /**
+     * \brief Returns the number of nodes of a subtree built over `count` points.
+     * 
+     * The median split makes the shape of the tree depend only on the number of points,
+     * so the position of every node in the buffer is known before the build starts and
+     * the two halves can be built in parallel without synchronization.
+     * 
+     * \param count The number of points of the subtree.
+     * \return The number of nodes of the subtree.
+     */
+    std::size_t countNodes(std::size_t count);
 
     /**
      * \brief Recursively builds the KD-tree from a subset of points.
      * 
      * The function partitions the points along a selected dimension and creates child nodes recursively.
+     * Subtrees of at least `TASK_MIN_POINTS` points are built by separate OpenMP tasks. The
+     * leaves scan their points once, to compute their bounds and sums and to copy their
+     * coordinates in tree order; the bounds and sums of the internal nodes are then combined
+     * from their children.
      * 
-     * \param begin Iterator pointing to the beginning of the subset.
-     * \param end Iterator pointing to the end of the subset.
+     * \param points The point set the tree is built from.
+     * \param nodeIndex Position of the node to build in the node buffer.
+     * \param begin First position of the subset in the index permutation.
+     * \param end One past the last position of the subset in the index permutation.
      * \param depth Current depth in the tree (used to determine the splitting dimension).
-     * \return A unique pointer to the constructed KdNode.
      */
-    std::unique_ptr<KdNode<PT, PD>> buildTree(typename std::vector<Point<PT, PD>>::iterator begin,
-                                              typename std::vector<Point<PT, PD>>::iterator end,
-                                              int depth);
+    void buildTree(const PointSet<PT, PD>& points, int32_t nodeIndex, int32_t begin, int32_t end, int depth);
 
     /**
-     * \brief Clears the KD-tree by recursively deleting all nodes.
+     * \brief Moves the point of rank `median` along an axis to its sorted position in a range of the index permutation.
      * 
-     * The function traverses the tree in post-order and deletes each node.
+     * The smaller points end up before it and the larger ones after it, as with `std::nth_element`.
+     * Ranges of at least `PARALLEL_SELECT_MIN_POINTS` points are narrowed first by three-way
+     * partitions around the median of a sample, whose chunks are counted and scattered by tasks.
      * 
-     * \param node Reference to the root node of the subtree to be cleared.
+     * \param axisValues The coordinates of the points along the splitting axis.
+     * \param begin First position of the range in the index permutation.
+     * \param median Position of the selected rank.
+     * \param end One past the last position of the range.
+     */
+    void selectMedian(const PT* axisValues, int32_t begin, int32_t median, int32_t end);
+
+    /**
+     * \brief Clears the KD-tree by releasing the node buffer and the index permutation.
      */
-    void clearTree(std::unique_ptr<KdNode<PT, PD>>& node);
+    void clearTree();
 
 };
 
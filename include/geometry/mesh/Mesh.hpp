@@ -8,6 +8,10 @@
 #include <exception>
 #include <string>
 #include <filesystem>
+#include <functional>
+#include <cstdint>
+
+#include "utils/Span.hpp"
 
 /**
  * \typedef VertId
@@ -41,11 +45,19 @@ typedef unsigned int FaceId; /**< Alias for unsigned int representing face ID. *
 class Mesh
 {
 public:
+  /**
+   * \brief Cluster label of a face that has not been assigned to any cluster.
+   */
+  static constexpr int32_t UNASSIGNED_CLUSTER = -1;
+
   /**
    * \brief Constructor to initialize the mesh from a file.
    *
    * This constructor takes a file path, reads the mesh data, and initializes
-   * the vertices, faces, and adjacency relationships.
+   * the vertices, faces, and adjacency relationships. A `.kmesh` file is read as a
+   * binary cache. For an .obj file, the cache `<path>.kmesh` next to it is read if it
+   * is up to date; otherwise the .obj file is parsed, its face adjacency built and the
+   * cache written, unless disabled with `MeshCache::setEnabled`.
    *
    * \param path The file path to the mesh data.
    */
@@ -68,10 +80,30 @@ public:
    * \brief Builds the face adjacency relationships for the mesh.
    *
    * This method computes the adjacency list for each face in the mesh, storing
-   * the adjacent faces for each face ID.
+   * the adjacent faces (faces sharing at least one vertex) in compressed sparse row
+   * arrays: the neighbors of face `f` are `adjacencyIndices[adjacencyOffsets[f]]` to
+   * `adjacencyIndices[adjacencyOffsets[f + 1] - 1]`, sorted by id. The vertex to face
+   * incidence is built with a counting sort, the neighbor lists in parallel.
+   * Nothing is done if the adjacency is already built for the current faces.
    */
   void buildFaceAdjacency();
 
+  /**
+   * \brief Precomputes a weight for every adjacency edge.
+   *
+   * The weights are stored alongside the neighbor indices, in the same order, so a
+   * graph search reads them sequentially instead of recomputing them on every relaxation.
+   * Builds the adjacency first if needed.
+   *
+   * \param weight Function returning the weight of the edge from the first face to the second one.
+   */
+  void buildFaceAdjacencyWeights(const std::function<double(FaceId, FaceId)> &weight);
+
+  /**
+   * \brief Returns true if the adjacency weights are computed for the current adjacency.
+   */
+  bool hasFaceAdjacencyWeights() const { return !adjacencyWeights.empty() && adjacencyWeights.size() == adjacencyIndices.size(); }
+
   /**
    * \brief Overloads the output stream operator to print the mesh.
    *
@@ -93,7 +125,7 @@ public:
    * \param face The ID of the face.
    * \return The cluster ID of the face, or -1 if not assigned.
    */
-  const int getFaceCluster(FaceId face) const;
+  int getFaceCluster(FaceId face) const { return face < faceClusters.size() ? faceClusters[face] : UNASSIGNED_CLUSTER; }
 
   /**
    * \brief Sets the cluster ID for a specified face.
@@ -103,7 +135,34 @@ public:
    * \param face The ID of the face.
    * \param cluster The cluster ID to be assigned to the face.
    */
-  void setFaceCluster(const FaceId face, const int cluster) { faceClusters[face] = cluster; }
+  void setFaceCluster(const FaceId face, const int cluster)
+  {
+    if (face >= faceClusters.size())
+    {
+      faceClusters.resize(face + 1, UNASSIGNED_CLUSTER);
+    }
+    faceClusters[face] = cluster;
+  }
+
+  /**
+   * \brief Gets the cluster ID of every face.
+   *
+   * \return A view of `numFaces()` labels, `UNASSIGNED_CLUSTER` for the faces without a cluster.
+   */
+  Span<const int32_t> getFaceClusters() const { return Span<const int32_t>(faceClusters); }
+
+  /**
+   * \brief Sets the cluster ID of every face at once.
+   *
+   * \param clusters The labels of the faces, one per face.
+   * \throws std::invalid_argument If the number of labels differs from the number of faces.
+   */
+  void setFaceClusters(Span<const int32_t> clusters);
+
+  /**
+   * \brief Marks every face as not assigned to any cluster.
+   */
+  void resetFaceClusters() { faceClusters.assign(meshFaces.size(), UNASSIGNED_CLUSTER); }
 
   /**
    * \brief Gets the list of points representing the face centroids of the mesh.
@@ -142,21 +201,32 @@ public:
    * \return A reference to the mesh vertices.
    */
   std::vector<Point<double, 3>> &getVertices() { return meshVertices; }
-  const
-
-      /**
-       * \brief Gets the list of faces adjacent to a given face.
-       *
-       * This method returns the adjacent faces for a given face identified by the
-       * FaceId.
-       *
-       * \param id The ID of the face.
-       * \return A vector of FaceIds representing the adjacent faces.
-       */
-      std::vector<FaceId>
-      getFaceAdjacencyAt(const FaceId id) const
+
+  /**
+   * \brief Gets the list of faces adjacent to a given face.
+   *
+   * This method returns the adjacent faces for a given face identified by the
+   * FaceId, as a view over the compressed adjacency arrays.
+   *
+   * \param id The ID of the face.
+   * \return A view of the FaceIds representing the adjacent faces.
+   */
+  Span<const FaceId> getFaceAdjacencyAt(const FaceId id) const
   {
-    return faceAdjacency.at(id);
+    return Span<const FaceId>(adjacencyIndices.data() + adjacencyOffsets[id], adjacencyOffsets[id + 1] - adjacencyOffsets[id]);
+  }
+
+  /**
+   * \brief Gets the precomputed weights of the edges from a given face to its neighbors.
+   *
+   * The i-th weight belongs to the i-th face returned by `getFaceAdjacencyAt`.
+   *
+   * \param id The ID of the face.
+   * \return A view of the weights of the adjacency edges of the face.
+   */
+  Span<const double> getFaceAdjacencyWeightsAt(const FaceId id) const
+  {
+    return Span<const double>(adjacencyWeights.data() + adjacencyOffsets[id], adjacencyOffsets[id + 1] - adjacencyOffsets[id]);
   }
 
   /**
@@ -193,11 +263,12 @@ public:
    * \brief Gets the adjacency relationships for the faces in the mesh.
    *
    * This method returns a map where each face ID is associated with a vector
-   * of adjacent face IDs.
+   * of adjacent face IDs. The map is built from the compressed arrays on every call,
+   * hot paths should use `getFaceAdjacencyAt` instead.
    *
    * \return A map representing the adjacency relationships of faces.
    */
-  std::unordered_map<FaceId, std::vector<FaceId>> getFaceAdjacency() const { return faceAdjacency; }
+  std::unordered_map<FaceId, std::vector<FaceId>> getFaceAdjacency() const;
 
   /**
    * \brief Gets the list of faces in the mesh.
@@ -208,14 +279,30 @@ public:
    */
   std::vector<Face> getMeshFaces() const { return meshFaces; }
 
+  /**
+   * \brief Computes a hash of the geometry of the mesh.
+   *
+   * The 64-bit FNV-1a hash of the vertex coordinates and of the vertex indices of the
+   * faces. Two meshes with the same hash can share data that only depends on their
+   * geometry, such as precomputed operators. The clusters are not part of the hash.
+   *
+   * \return The hash of the mesh content.
+   */
+  uint64_t contentHash() const;
+
   void addVertex(const Point<double, 3> &vertex);
   void addFace(const Face &face);
 
 private:
+  friend class MeshCache;
+  friend class ObjReader;
+
   std::vector<Point<double, 3>> meshVertices;                    /**< List of vertices in the mesh. */
   std::vector<Face> meshFaces;                                   /**< List of faces in the mesh. */
-  std::unordered_map<FaceId, int> faceClusters;                  /**< Map of face IDs to cluster IDs. */
-  std::unordered_map<FaceId, std::vector<FaceId>> faceAdjacency; /**< Adjacency map for faces. */
+  std::vector<int32_t> faceClusters;                             /**< Cluster ID of each face, UNASSIGNED_CLUSTER if not assigned. */
+  std::vector<uint32_t> adjacencyOffsets;                        /**< Start of the neighbors of each face in adjacencyIndices (CSR offsets). */
+  std::vector<FaceId> adjacencyIndices;                          /**< Neighbors of all the faces, concatenated (CSR indices). */
+  std::vector<double> adjacencyWeights;                          /**< Optional weight of each adjacency edge, parallel to adjacencyIndices. */
 };
 
 #endif // MESH_HPP
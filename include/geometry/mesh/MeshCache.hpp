@@ -0,0 +1,76 @@
+#ifndef MESH_CACHE_HPP
+#define MESH_CACHE_HPP
+
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+#include "geometry/mesh/Mesh.hpp"
+#include "utils/BinaryCache.hpp"
+
+/**
+ * \class MeshCache
+ * \brief Versioned binary format of a mesh with its precomputed face data.
+ *
+ * Parsing an .obj file, computing the area, normal and baricenter of every face and
+ * building the face adjacency dominate the start of a segmentation. A `.kmesh` file
+ * stores all of them as flat arrays:
+ *
+ *  - a header with a magic number, the format version, the stamp of the source file,
+ *    the content hash of the mesh and the number of vertices, faces and adjacency entries;
+ *  - the vertex coordinates, the vertex indices of the faces;
+ *  - the baricenters, normals and areas of the faces;
+ *  - the CSR adjacency of the faces (offsets and indices).
+ *
+ * The file is memory-mapped and the arrays are copied into the mesh without any
+ * parsing or geometric computation. A file with another magic, version or size, or
+ * with out of range indices, is rejected.
+ *
+ * `Mesh(path)` writes the cache of an .obj file next to it on the first load, as
+ * `<file>.kmesh`, and reads it on the following loads while the source is unchanged.
+ */
+class MeshCache
+{
+public:
+    /**
+     * \brief Extension of the cache files.
+     */
+    static constexpr const char *EXTENSION = ".kmesh";
+
+    /**
+     * \brief Version of the format, incremented when the layout changes.
+     */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * \brief Writes a mesh to a cache file, building its face adjacency first if needed.
+     *
+     * \param mesh The mesh to write.
+     * \param path The path of the cache file.
+     * \param source The stamp of the source file of the mesh, zero if there is none.
+     * \return True if the file was written.
+     */
+    static bool save(Mesh &mesh, const std::filesystem::path &path, const BinaryCache::SourceStamp &source = {});
+
+    /**
+     * \brief Reads a mesh from a cache file.
+     *
+     * \param path The path of the cache file.
+     * \param mesh The mesh receiving the data, only modified on success.
+     * \param source If not null, the cache is rejected unless it was written for this source stamp.
+     * \return False if the file is missing, stale, truncated, corrupted or from another version.
+     */
+    static bool load(const std::filesystem::path &path, Mesh &mesh, const BinaryCache::SourceStamp *source = nullptr);
+
+    /**
+     * \brief Enables or disables the automatic cache of `Mesh(path)`, enabled by default.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * \brief Tells whether `Mesh(path)` reads and writes the cache next to the source.
+     */
+    static bool isEnabled();
+};
+
+#endif // MESH_CACHE_HPP
@@ -0,0 +1,43 @@
+#ifndef OBJ_READER_HPP
+#define OBJ_READER_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "geometry/mesh/Mesh.hpp"
+
+/**
+ * \class ObjReader
+ * \brief Parallel reader of the vertices and faces of Wavefront .obj files.
+ *
+ * The file is memory-mapped and split into chunks at line boundaries. A first pass
+ * counts the vertices and triangles of every chunk, a prefix sum gives the position of
+ * each chunk in the mesh, and a second pass parses the chunks in parallel directly into
+ * the vertex and face storage of the mesh.
+ *
+ * Only the `v` and `f` lines are read, the other statements (`vt`, `vn`, `g`, `o`,
+ * `usemtl`, comments...) are skipped, so the faces of all the groups belong to the
+ * mesh. A face vertex may be written `v`, `v/vt`, `v//vn` or `v/vt/vn`, only the vertex
+ * index is used; negative indices are relative to the last vertex defined before the
+ * face. Polygons with more than three vertices are split into a fan of triangles.
+ */
+class ObjReader
+{
+public:
+    /**
+     * \brief Minimum size of the chunks parsed by one thread, in bytes.
+     */
+    static constexpr std::size_t MIN_CHUNK_BYTES = std::size_t(1) << 16;
+
+    /**
+     * \brief Reads an .obj file into a mesh.
+     *
+     * \param path The path of the .obj file.
+     * \param mesh The mesh receiving the vertices and faces, all faces unassigned.
+     * \throws std::runtime_error If the file cannot be read, has no face, or a vertex or face is invalid.
+     */
+    static void read(const std::string &path, Mesh &mesh);
+};
+
+#endif // OBJ_READER_HPP
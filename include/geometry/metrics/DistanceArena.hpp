@@ -0,0 +1,89 @@
+#ifndef DISTANCE_ARENA_HPP
+#define DISTANCE_ARENA_HPP
+
+#include <new>
+#include <memory>
+#include <cstddef>
+
+/**
+ * \class DistanceArena
+ * \brief Preallocated matrix of distance fields, one aligned row per centroid.
+ *
+ * A geodesic metric stores the distance from the seed face of every centroid to all
+ * the faces. The fields are the K rows of a single buffer, allocated once and written
+ * in place at every iteration. Every row starts on a 64-byte boundary, so a row is
+ * owned by whole cache lines and the threads writing different rows never share one.
+ * The assignment step reads the matrix column-wise: a block of faces streams the same
+ * range of every row.
+ *
+ * \tparam T The type of the stored distances (e.g., float, double).
+ */
+template <typename T>
+class DistanceArena
+{
+public:
+    /**
+     * \brief Alignment of the buffer and of every row, in bytes.
+     */
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    /**
+     * \brief Shapes the arena for a number of fields of a number of faces.
+     *
+     * The buffer is only reallocated when it is too small, the rows are kept if the
+     * shape does not change.
+     *
+     * \param rows The number of fields.
+     * \param columns The number of faces of every field.
+     * \return True if the shape did not change, so the rows still hold their fields.
+     */
+    bool resize(std::size_t rows, std::size_t columns);
+
+    /**
+     * \brief Releases the buffer, the arena becomes empty.
+     */
+    void release();
+
+    /**
+     * \brief Returns the first distance of a row, aligned to `ALIGNMENT` bytes.
+     */
+    T *row(std::size_t index) { return buffer.get() + index * rowStride; }
+    const T *row(std::size_t index) const { return buffer.get() + index * rowStride; }
+
+    /**
+     * \brief Returns the number of rows.
+     */
+    std::size_t rows() const { return numRows; }
+
+    /**
+     * \brief Returns the number of distances of every row.
+     */
+    std::size_t columns() const { return numColumns; }
+
+    /**
+     * \brief Returns the number of elements between the starts of two consecutive rows.
+     */
+    std::size_t stride() const { return rowStride; }
+
+    /**
+     * \brief Returns the size of the allocated buffer, in bytes.
+     */
+    std::size_t capacityBytes() const { return capacity * sizeof(T); }
+
+private:
+    /**
+     * \brief Releases a buffer allocated with the alignment of the arena.
+     */
+    struct AlignedDelete
+    {
+        void operator()(T *data) const { ::operator delete[](data, std::align_val_t(ALIGNMENT)); }
+    };
+
+    std::unique_ptr<T[], AlignedDelete> buffer; ///< Rows of the matrix, `rowStride` elements apart.
+    std::size_t capacity = 0;                   ///< Number of elements of the buffer.
+    std::size_t numRows = 0;                    ///< Number of rows in use.
+    std::size_t numColumns = 0;                 ///< Number of distances of every row.
+    std::size_t rowStride = 0;                  ///< Row length rounded up to a multiple of `ALIGNMENT` bytes.
+};
+
+#endif // DISTANCE_ARENA_HPP
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <cmath>
 #include <stdexcept>
 
@@ -27,6 +28,11 @@ void kmeans_cuda(int K, int dim, int numPoints, float *points, float *centroids,
  * efficiently find nearest neighbors and compute distances. On the GPU, it uses CUDA
  * to parallelize the computation and speed up the process.
  * 
+ * The kd-tree filter prunes whole cells of points, which pays off for few clusters in
+ * low dimension. For many clusters or higher dimensions the CPU fit can instead scan
+ * the flat point set and skip most distance computations with the bounds of Hamerly's
+ * or Elkan's algorithm, see `Engine`.
+ * 
  * \tparam PT Type of the point (e.g., float, double)
  * \tparam PD Dimension of the point (e.g., 2D, 3D)
  */
@@ -35,7 +41,38 @@ class EuclideanMetric : public Metric<PT, PD>
 {
 public:
     /**
-     * \brief Default constructor for EuclideanMetric.
+     * \brief Algorithm used by the CPU fit.
+     */
+    enum class Engine
+    {
+        AUTO,          ///< Chosen by `selectEngine` from the number of points, clusters and dimensions.
+        KDTREE_FILTER, ///< Kd-tree filtering, whole cells are assigned to a single centroid.
+        HAMERLY,       ///< Hamerly's algorithm, one upper and one lower bound per point.
+        ELKAN          ///< Elkan's algorithm, one upper bound and one lower bound per point and centroid.
+    };
+
+    /**
+     * \brief Smallest number of points per cluster for which `Engine::AUTO` uses the kd-tree filter.
+     */
+    static constexpr std::size_t KDTREE_MIN_POINTS_PER_CLUSTER = 64;
+
+    /**
+     * \brief Largest number of dimensions for which `Engine::AUTO` uses the kd-tree filter.
+     */
+    static constexpr std::size_t KDTREE_MAX_DIMENSIONS = 3;
+
+    /**
+     * \brief Smallest number of dimensions for which `Engine::AUTO` prefers Elkan's algorithm.
+     */
+    static constexpr std::size_t ELKAN_MIN_DIMENSIONS = 16;
+
+    /**
+     * \brief Largest number of lower bounds (points times clusters) kept by Elkan's algorithm.
+     */
+    static constexpr std::size_t ELKAN_MAX_BOUNDS = std::size_t(1) << 26;
+
+    /**
+     * \brief Default constructor for EuclideanMetric.",
      * 
      * Initializes an instance of the EuclideanMetric class with default settings.
      */
@@ -46,8 +83,9 @@ public:
      * 
      * \param data The data points used for the metric computation.
      * \param threshold The threshold value for metric computation.
+     * \param engine The algorithm used by the CPU fit.
      */
-    EuclideanMetric(std::vector<Point<PT, PD>> data, double threshold);
+    EuclideanMetric(std::vector<Point<PT, PD>> data, double threshold, Engine engine = Engine::AUTO);
 
     /**
      * \brief Constructor that initializes the metric with a mesh, threshold, and data points.
@@ -55,8 +93,42 @@ public:
      * \param mesh The mesh containing the geometry for the metric computation.
      * \param percentage_threshold The threshold percentage used for calculations.
      * \param data The data points used for the metric computation.
+     * \param engine The algorithm used by the CPU fit.
+     */
+    EuclideanMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data, Engine engine = Engine::AUTO);
+
+    /**
+     * \brief Chooses the algorithm of the CPU fit for a problem size.
+     * 
+     * The kd-tree filter is used in up to `KDTREE_MAX_DIMENSIONS` dimensions with at least
+     * `KDTREE_MIN_POINTS_PER_CLUSTER` points per cluster, where most cells are pruned down to
+     * a single candidate. With fewer points per cluster the cells rarely are, and skipping
+     * points with bounds is faster. Otherwise
+     * Elkan's algorithm is used from `ELKAN_MIN_DIMENSIONS` dimensions, where a distance is
+     * expensive enough to justify its K bounds per point, as long as they fit in
+     * `ELKAN_MAX_BOUNDS`. Hamerly's algorithm covers the remaining cases.
+     * 
+     * \param numPoints The number of data points.
+     * \param numClusters The number of centroids.
+     * \return An engine other than `Engine::AUTO`.
      */
-    EuclideanMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data);
+    static Engine selectEngine(std::size_t numPoints, std::size_t numClusters)
+    {
+        if (PD <= KDTREE_MAX_DIMENSIONS && numPoints >= KDTREE_MIN_POINTS_PER_CLUSTER * numClusters)
+        {
+            return Engine::KDTREE_FILTER;
+        }
+        if (PD >= ELKAN_MIN_DIMENSIONS && numPoints * numClusters <= ELKAN_MAX_BOUNDS)
+        {
+            return Engine::ELKAN;
+        }
+        return Engine::HAMERLY;
+    }
+
+    /**
+     * \brief Gets the algorithm requested at construction, possibly `Engine::AUTO`.
+     */
+    Engine getEngine() const { return engine; }
 
     /**
      * \brief Computes the Euclidean distance between two points.
@@ -69,6 +141,55 @@ public:
      */
     static PT distanceTo(const Point<PT, PD> &a, const Point<PT, PD> &b);
 
+    /**
+     * \brief Computes the squared Euclidean distance between two points.
+     * 
+     * Monotonic in the Euclidean distance, so it is the one to use when distances are
+     * only compared. The kernel is unrolled at compile time for 2D and 3D points.
+     * 
+     * \param a The first point.
+     * \param b The second point.
+     * \return The squared Euclidean distance between the two points.
+     */
+    static PT squaredDistance(const Point<PT, PD> &a, const Point<PT, PD> &b)
+    {
+        return squaredDistance(a.coordinates, b.coordinates);
+    }
+
+    /**
+     * \brief Computes the squared Euclidean distance between two coordinate arrays.
+     * 
+     * \param a The coordinates of the first point.
+     * \param b The coordinates of the second point.
+     * \return The squared Euclidean distance between the two points.
+     */
+    static PT squaredDistance(const std::array<PT, PD> &a, const std::array<PT, PD> &b)
+    {
+        if constexpr (PD == 2)
+        {
+            const PT dx = a[0] - b[0];
+            const PT dy = a[1] - b[1];
+            return dx * dx + dy * dy;
+        }
+        else if constexpr (PD == 3)
+        {
+            const PT dx = a[0] - b[0];
+            const PT dy = a[1] - b[1];
+            const PT dz = a[2] - b[2];
+            return dx * dx + dy * dy + dz * dz;
+        }
+        else
+        {
+            PT sum = 0;
+            for (std::size_t i = 0; i < PD; ++i)
+            {
+                const PT diff = a[i] - b[i];
+                sum += diff * diff;
+            }
+            return sum;
+        }
+    }
+
     /**
      * \brief Setup method to initialize necessary components before fitting the model.
      * 
@@ -102,35 +223,123 @@ public:
     std::vector<Point<PT, PD>> &getPoints() override;
 
 private:
-    Mesh *mesh; /**< Pointer to the mesh object for the metric calculation. */
+    Mesh *mesh = nullptr; /**< Pointer to the mesh object for the metric calculation. */
     double treshold; /**< The threshold value for the metric. */
-    std::unique_ptr<KdTree<PT, PD>> kdtree; /**< Pointer to the KDTree used for nearest-neighbor search. */
+    std::unique_ptr<KdTree<PT, PD>> kdtree; /**< Pointer to the KDTree used for nearest-neighbor search, built on the first kd-tree fit. */
+    Engine engine = Engine::AUTO; /**< Algorithm used by the CPU fit. */
+    std::vector<PT> upperBounds; /**< Upper bound of the distance of each point from its centroid. */
+    std::vector<PT> lowerBounds; /**< Lower bounds of the distance of each point from the other centroids, one (Hamerly) or K (Elkan) per point. */
+    std::vector<PT> boundCenters; /**< Coordinates of the centroids the bounds refer to, K * PD values, empty if the bounds are not valid. */
+    std::vector<std::vector<HasWgtCent<PT, PD>>> threadSums; /**< Sum and number of the points assigned to each centroid by each thread during a kd-tree filtering pass. */
+    int taskDepth = 0; /**< Depth of the kd-tree down to which the filtering spawns a task per subtree. */
+    std::vector<int32_t> candidateSlots; /**< Candidate lists of the nodes above `taskDepth`, K labels per node in heap order (more than 64 centroids only). */
+    std::vector<std::vector<int32_t>> candidateStacks; /**< Candidate lists of the nodes below `taskDepth`, per thread, K labels per level (more than 64 centroids only). */
+
+    /**
+     * \brief Levels of tasks spawned below the depth that gives one subtree per thread.
+     * 
+     * The subtrees are pruned unevenly, a few tasks per thread let the idle threads
+     * pick up the remaining ones.
+     */
+    static constexpr int TASK_DEPTH_SLACK = 3;
+
+    /**
+     * \brief Largest number of centroids whose candidate sets are stored as a bit mask.
+     */
+    static constexpr std::size_t MAX_MASK_CANDIDATES = 64;
+
+    /**
+     * \brief Candidate centroids of a kd-tree node as a list of labels, for more than 64 centroids.
+     * 
+     * The labels live in `candidateSlots` or `candidateStacks`, so the list is copied by value.
+     */
+    struct CandidateList
+    {
+        const int32_t *labels; ///< Labels of the candidates, in increasing order.
+        int32_t size;          ///< Number of candidates.
+    };
+
+    /**
+     * \brief Runs one iteration of Hamerly's or Elkan's algorithm.
+     * 
+     * The bounds are moved by the drift of the centroids since the previous iteration,
+     * the points whose bounds do not prove their assignment are rechecked, then the
+     * centroids are recomputed from the labels. The first iteration after
+     * `boundCenters` is cleared scans every point.
+     * 
+     * \param elkan True for Elkan's algorithm, false for Hamerly's.
+     */
+    void boundedIteration(bool elkan);
 
     /**
-     * \brief Filters the data points based on certain criteria.
+     * \brief Runs one iteration of the kd-tree filtering algorithm.
      * 
-     * This private method is used to filter out irrelevant or unneeded data points 
-     * from the dataset.
+     * The tree is traversed by a team of threads, every thread adds the points it assigns
+     * to its own entry of `threadSums`, and the sums are reduced into the centroids at the end.
+     * The candidate sets are a 64-bit mask with up to `MAX_MASK_CANDIDATES` centroids, and lists
+     * in buffers allocated on the first pass otherwise, so a pass does not allocate memory.
      */
     void filter();
 
     /**
      * \brief Recursively filters data points in the KDTree structure.
      * 
-     * \param node The current KDNode being processed.
-     * \param candidates A list of candidate centroids to compare.
+     * Above `taskDepth` the left subtree is filtered by a new task while the current
+     * thread filters the right one.
+     * 
+     * \tparam Candidates `uint64_t` bit mask or `CandidateList`.
+     * \param nodeIndex The position of the current KDNode in the node buffer of the tree.
+     * \param candidates The candidate centroids of the node.
      * \param depth The current depth of the recursion.
+     * \param slot The position of the node in heap order (the root is 1, the children of `s` are `2s` and `2s + 1`).
+     */
+    template <typename Candidates>
+    void filterRecursive(int32_t nodeIndex, Candidates candidates, int depth, std::size_t slot);
+
+    /**
+     * \brief Keeps the candidates that may be the closest one to some point of a node.
+     * 
+     * \param candidates The candidate centroids of the node.
+     * \param zStar The candidate closest to the midpoint of the cell, always kept.
+     * \param node The current KDNode.
+     * \param depth The depth of the node.
+     * \param slot The position of the node in heap order.
+     * \return The remaining candidates.
+     */
+    uint64_t pruneCandidates(uint64_t candidates, int32_t zStar, const KdNode<PT, PD> &node, int depth, std::size_t slot);
+    CandidateList pruneCandidates(CandidateList candidates, int32_t zStar, const KdNode<PT, PD> &node, int depth, std::size_t slot);
+
+    /**
+     * \brief Assigns every point of a leaf bucket to its closest candidate.
+     * 
+     * Used when more than one candidate survives the pruning at a leaf. The distances
+     * are computed by a SIMD kernel that streams the tree-ordered coordinates of the
+     * bucket against one candidate at a time.
+     * 
+     * \param node The leaf KDNode.
+     * \param candidates The candidate centroids that survived the pruning.
+     */
+    template <typename Candidates>
+    void assignBucket(const KdNode<PT, PD> &node, Candidates candidates);
+
+    /**
+     * \brief Adds a group of points to the sums of the calling thread for a centroid.
+     * 
+     * \param label The index of the centroid.
+     * \param wgtCent The sum of the coordinates of the points.
+     * \param count The number of points.
      */
-    void filterRecursive(std::unique_ptr<KdNode<PT, PD>> &node, const std::vector<std::shared_ptr<CentroidPoint<PT, PD>>> &candidates, int depth);
+    void addToCentroid(int32_t label, const std::array<PT, PD> &wgtCent, int count);
 
     /**
      * \brief Finds the closest candidate centroid to a given target point.
      * 
-     * \param candidates A list of candidate centroids.
-     * \param target The target point to find the closest centroid to.
-     * \return The closest centroid to the target.
+     * \param candidates The candidate centroids.
+     * \param target The coordinates of the target point to find the closest centroid to.
+     * \return The label of the closest centroid to the target, the lowest one on ties.
      */
-    std::shared_ptr<CentroidPoint<PT, PD>> findClosestCandidate(const std::vector<std::shared_ptr<CentroidPoint<PT, PD>>> &candidates, const Point<PT, PD> &target);
+    template <typename Candidates>
+    int32_t findClosestCandidate(Candidates candidates, const std::array<PT, PD> &target) const;
 
     /**
      * \brief Checks if a point is farther from a reference point than another.
@@ -143,12 +352,12 @@ private:
     bool isFarther(const Point<PT, PD> &z, const Point<PT, PD> &zStar, const KdNode<PT, PD> &node);
 
     /**
-     * \brief Assigns a centroid to a node in the KDTree.
+     * \brief Assigns a centroid to all the points of a node in the KDTree.
      * 
      * \param node The current KDNode.
-     * \param centroid The centroid to be assigned.
+     * \param label The index of the centroid to be assigned.
      */
-    void assignCentroid(std::unique_ptr<KdNode<PT, PD>> &node, const std::shared_ptr<CentroidPoint<PT, PD>> &centroid);
+    void assignCentroid(const KdNode<PT, PD> &node, int32_t label);
 
     /**
      * \brief Checks for convergence of the clustering algorithm.
@@ -2,6 +2,7 @@
 #define GEODESICMETRIC_HPP
 
 #include <queue>
+#include <atomic>
 #include <utility>
 #include <optional>
 #include <functional>
@@ -9,11 +10,19 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
+#include <mutex>
+#include <memory>
 #include <omp.h>
 #include "geometry/mesh/Mesh.hpp"
 #include "geometry/metrics/Metric.hpp"
 #include "geometry/point/CentroidPoint.hpp"
+#include "geometry/metrics/GeodesicDistanceCache.hpp"
+#include "geometry/metrics/DistanceArena.hpp"
+#include "geometry/kdtree/KDTree.hpp"
+#include "utils/RadixHeap.hpp"
 
 #ifdef USE_CUDA
 // CUDA kernel for geodesic-based clustering
@@ -29,6 +38,36 @@ void kmeans_cuda_geodesic(
 );
 #endif
 
+/**
+ * \struct DijkstraWorkspace
+ * \brief Scratch memory of a single-source Dijkstra search, reused across searches.
+ *
+ * A face is settled when its stamp equals the epoch of the current search, so
+ * starting a new search only increments the epoch instead of clearing N flags.
+ * Every thread owns one workspace (see `dijkstraWorkspace`).
+ */
+struct DijkstraWorkspace
+{
+    std::vector<uint32_t> settled; ///< Epoch of the last search that settled each face.
+    uint32_t epoch = 0;            ///< Epoch of the current search.
+    RadixHeap<FaceId> heap;        ///< Faces to visit, ordered by tentative distance.
+
+    /**
+     * \brief Prepares the workspace for a new search on a mesh.
+     *
+     * \param numFaces The number of faces of the mesh.
+     */
+    void reset(std::size_t numFaces);
+
+    bool isSettled(FaceId face) const { return settled[face] == epoch; }
+    void settle(FaceId face) { settled[face] = epoch; }
+};
+
+/**
+ * \brief Workspace of the Dijkstra searches run by the calling thread.
+ */
+extern thread_local DijkstraWorkspace dijkstraWorkspace;
+
 /**
  * \class GeodesicDijkstraMetric
  * \brief A class for computing geodesic distances on a mesh with Dijkstra's algorithm
@@ -45,6 +84,28 @@ template <typename PT, std::size_t PD>
 class GeodesicDijkstraMetric : public Metric<PT, PD>
 {
 public:
+    /**
+     * \brief Algorithm used to compute a single distance field.
+     */
+    enum class SearchEngine
+    {
+        AUTO,          ///< Delta-stepping when there are fewer centroids than threads, Dijkstra otherwise.
+        DIJKSTRA,      ///< Serial Dijkstra, the fields of the centroids are computed in parallel.
+        DELTA_STEPPING ///< Parallel delta-stepping, the fields of the centroids are computed one at a time.
+    };
+
+    /**
+     * \brief Work done by the assignment step of one iteration.
+     */
+    struct AssignmentStats
+    {
+        size_t numFaces = 0;               ///< Number of faces to assign.
+        size_t skippedByBounds = 0;        ///< Faces kept in their cluster without reading any distance.
+        size_t skippedAfterTightening = 0; ///< Faces kept in their cluster after reading the distance from their centroid.
+        size_t fullScans = 0;              ///< Faces compared with all the centroids.
+        size_t changed = 0;                ///< Faces that moved to another cluster.
+    };
+
     /**
      * \brief Constructor that initializes the geodesic metric with a mesh and data points.
      * 
@@ -81,14 +142,27 @@ public:
     /**
      * \brief Finds the closest face on the mesh to a given point (centroid).
      * 
-     * This method finds the face in the mesh that is closest 
-     * to the provided point, based on Euclidean distance.
+     * This method finds the face in the mesh whose baricenter is closest 
+     * to the provided point, based on Euclidean distance. The query runs on the kd-tree
+     * of the baricenters returned by `getFaceIndex()`, so it takes O(log N) and can be
+     * called concurrently for all the centroids. Ties go to the face with the lowest id.
      * 
      * \param centroid The point for which the closest face is to be found.
      * \return The FaceId of the closest face to the centroid.
      */
     FaceId findClosestFace(const Point<PT, PD> &centroid) const;
 
+    /**
+     * \brief Gets the kd-tree of the face baricenters, building it on the first call.
+     * 
+     * The tree is rebuilt only if the number of faces of the mesh changed. It is built
+     * by `setupAdjacency()` at the start of every fit, outside the parallel loops over
+     * the centroids. Thread-safe.
+     * 
+     * \return A shared pointer to the tree, whose point indices are face ids.
+     */
+    std::shared_ptr<const KdTree<PT, PD>> getFaceIndex() const;
+
     /**
      * \brief Gets the data points (faces) used for the geodesic calculations.
      * 
@@ -96,11 +170,150 @@ public:
      */
     std::vector<Point<PT, PD>>& getPoints() override;
 
+    /**
+     * \brief Gets the cache of the distance fields computed by this metric.
+     * 
+     * \return A shared pointer to the cache, e.g. to change its memory budget.
+     */
+    std::shared_ptr<GeodesicDistanceCache<PT>> getDistanceCache() const { return distanceCache; }
+
+    /**
+     * \brief Replaces the cache of the distance fields.
+     * 
+     * Lets several metrics of the same type on the same mesh share their fields.
+     * 
+     * \param cache The cache to use, it must not be null.
+     */
+    void setDistanceCache(std::shared_ptr<GeodesicDistanceCache<PT>> cache) { distanceCache = std::move(cache); }
+
+    /**
+     * \brief Gets the algorithm used to compute the distance fields.
+     */
+    SearchEngine getSearchEngine() const { return searchEngine; }
+
+    /**
+     * \brief Selects the algorithm used to compute the distance fields.
+     * 
+     * \param engine The algorithm, `SearchEngine::AUTO` by default.
+     */
+    void setSearchEngine(SearchEngine engine) { searchEngine = engine; }
+
+    /**
+     * \brief Tells whether the distance fields of the centroids are stored in single precision.
+     */
+    bool useFloatDistances() const { return floatStorage; }
+
+    /**
+     * \brief Selects the precision of the distance fields of the centroids.
+     * 
+     * Single precision halves the memory of the K x N fields and the bandwidth of the
+     * assignment step. The fields are still computed in the precision of the metric,
+     * and the bounds are widened by the rounding error of a float.
+     * 
+     * \param enabled True to store the fields as floats, false (default) to store them as `PT`.
+     */
+    void setFloatDistances(bool enabled);
+
+    /**
+     * \brief Gets the statistics of the assignment step of every iteration of the last fit.
+     */
+    const std::vector<AssignmentStats> &getAssignmentStats() const { return assignmentStats; }
+
 protected:
     Mesh *mesh; /**< Pointer to the mesh used in geodesic calculations. */
-    std::unordered_map<FaceId, std::vector<PT>> distances; /**< Stores computed geodesic distances for each face. */
+    DistanceArena<PT> distances; /**< Distance field of each centroid, one row per centroid. */
+    DistanceArena<float> floatDistances; /**< Single precision fields, used instead of `distances` if `floatStorage` is set. */
+    bool floatStorage = false; /**< Whether the fields are stored in `floatDistances`. */
+    std::vector<FaceId> fieldSeeds; /**< Seed face of the field held by each row, NO_FIELD for an empty row. */
+    std::shared_ptr<GeodesicDistanceCache<PT>> distanceCache = std::make_shared<GeodesicDistanceCache<PT>>(); /**< Distance fields reused across iterations and fits. */
     int oldPoints = 0; /**< Keeps track of the number of points from previous iterations. */
     double avgDistances; /**< Stores the average geodesic distance used for convergence checks. */
+    double avgEdgeWeight = 0.0; /**< Average weight of the adjacency edges, used as bucket width by delta-stepping. */
+    SearchEngine searchEngine = SearchEngine::AUTO; /**< Algorithm used to compute the distance fields. */
+    std::vector<FaceId> seeds; /**< Face each centroid was snapped to by the last setup(), indexed by centroid. */
+    bool useBounds = true; /**< Whether assignFaces() may skip faces using the triangle inequality. */
+    std::vector<PT> upperBounds; /**< Upper bound of the distance of each face from its centroid. */
+    std::vector<PT> lowerBounds; /**< Lower bound of the distance of each face from any other centroid. */
+    std::vector<PT> drift; /**< Distance between the previous and the current seed of each centroid. */
+    bool driftKnown = false; /**< Whether every row held a field before the last setup(), so that all the drifts are known. */
+    std::vector<AssignmentStats> assignmentStats; /**< Statistics of the assignment step of each iteration. */
+    mutable std::shared_ptr<const KdTree<PT, PD>> faceIndex; /**< Kd-tree of the face baricenters, used to snap the centroids. */
+    mutable std::mutex faceIndexMutex; /**< Protects `faceIndex`. */
+
+    /**
+     * \brief Builds the face adjacency of the mesh and precomputes the edge weights.
+     * 
+     * Computes the average distance between adjacent baricenters, used to scale the
+     * dihedral term, and stores the weight of every edge in the mesh adjacency.
+     * Called once per fit, before the first iteration.
+     */
+    void setupAdjacency();
+
+    /**
+     * \brief Marks a row of the distance arena that holds no field.
+     */
+    static constexpr FaceId NO_FIELD = std::numeric_limits<FaceId>::max();
+
+    /**
+     * \brief Shapes the distance arena for the current centroids and mesh.
+     * 
+     * The rows are kept if the number of centroids and faces did not change, so that a
+     * centroid staying on its seed does not copy its field again. Resets the drifts.
+     */
+    void prepareFields();
+
+    /**
+     * \brief Moves a centroid to a seed face and tells whether its row already holds the field.
+     * 
+     * If the row holds the field of another seed, the drift of the centroid is read from
+     * it before it is overwritten. Only touches the row of the centroid, so the centroids
+     * can be processed in parallel.
+     * 
+     * \param centroidId The index of the centroid.
+     * \param seed The face the centroid was snapped to.
+     * \return True if the row already holds the field of `seed`.
+     */
+    bool retainField(size_t centroidId, FaceId seed);
+
+    /**
+     * \brief Copies the distance field of a seed face into the row of a centroid.
+     * 
+     * \param centroidId The index of the centroid.
+     * \param seed The face the centroid was snapped to.
+     * \param field The distance from the seed to every face.
+     */
+    void storeField(size_t centroidId, FaceId seed, const std::vector<PT> &field);
+
+    /**
+     * \brief Assigns every face to its closest centroid.
+     * 
+     * Reads the distance arena filled by `setup()` and stores in the mesh the
+     * index of the centroid with the smallest geodesic distance from each face.
+     * 
+     * Like Hamerly's algorithm, every face keeps an upper bound of the distance from its
+     * centroid and a lower bound of the distance from the others. When a centroid moves
+     * from one seed face to another, the distances from it change at most by the distance
+     * between the two seeds, so the bounds are shifted by that drift. A face whose upper
+     * bound stays below its lower bound keeps its cluster without scanning the K fields.
+     * 
+     * \return The number of faces whose cluster changed.
+     */
+    virtual size_t assignFaces();
+
+    /**
+     * \brief Assigns every face to its closest centroid, reading the fields from an arena.
+     * 
+     * \tparam ST The type of the stored distances.
+     * \param arena The arena holding the fields of the centroids.
+     * \return The number of faces whose cluster changed.
+     */
+    template <typename ST>
+    size_t assignFacesFrom(const DistanceArena<ST> &arena);
+
+    /**
+     * \brief Moves every centroid to the mean of the baricenters of its faces.
+     */
+    void updateCentroids();
 
     /**
      * \brief Computes the Euclidean distance between two points.
@@ -119,13 +332,38 @@ protected:
      * 
      * This method uses Dijkstra's algorithm to compute the shortest geodesic distances from 
      * a given starting face to all other faces in the mesh. The algorithm explores the 
-     * neighboring faces and accumulates the geodesic distances.
+     * neighboring faces and accumulates the geodesic distances. The faces are ordered by a
+     * radix heap and marked as settled in the workspace of the calling thread.
      * 
      * \param startFace The starting face from which distances will be calculated.
      * \return A vector of computed geodesic distances for the mesh faces.
      */
     virtual std::vector<PT> computeDistances(const FaceId startFace) const;
 
+    /**
+     * \brief Computes the geodesic distances starting from a given face using delta-stepping.
+     * 
+     * The faces are grouped in buckets of width `avgEdgeWeight` by tentative distance. The
+     * buckets are processed in increasing order and all the faces of a bucket relax their
+     * edges in parallel, until no distance in the bucket changes. The result is the same
+     * as `computeDistances`, but a single field uses all the threads.
+     * 
+     * \param startFace The starting face from which distances will be calculated.
+     * \return A vector of computed geodesic distances for the mesh faces.
+     */
+    std::vector<PT> computeDistancesDeltaStepping(const FaceId startFace) const;
+
+    /**
+     * \brief Tells whether each distance field should be computed by all the threads.
+     * 
+     * With `SearchEngine::AUTO` it is the case when there are fewer centroids than threads,
+     * since the parallel loop over the centroids would leave some threads idle.
+     * 
+     * \return True to use delta-stepping one centroid at a time, false to run one
+     * `computeDistances` per centroid in parallel.
+     */
+    virtual bool useParallelSearch() const;
+
     /**
      * \brief Stores the centroids after the fitting process.
      * 
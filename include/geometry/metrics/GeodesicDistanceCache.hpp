@@ -0,0 +1,145 @@
+#ifndef GEODESIC_DISTANCE_CACHE_HPP
+#define GEODESIC_DISTANCE_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+
+#include "geometry/mesh/Mesh.hpp"
+
+/**
+ * \class GeodesicDistanceCache
+ * \brief Least-recently-used cache of geodesic distance fields, keyed by seed face.
+ *
+ * A geodesic metric snaps every centroid to a face and computes the distance field
+ * from that face to all the others. Late iterations, the k sweeps of the Elbow and
+ * Silhouette methods and repeated fits on the same mesh keep seeding the same faces,
+ * so the fields are kept here and evicted in least-recently-used order once their
+ * total size exceeds a memory budget.
+ *
+ * The fields are handed out as shared pointers to immutable vectors: an evicted field
+ * stays valid for the callers still holding it. All the methods are thread-safe, the
+ * distance fields are computed outside the lock.
+ *
+ * A cache must only be shared by metrics computing the same kind of distance on the
+ * same mesh, since the seed face is the only key.
+ *
+ * \tparam PT The type of the distances (e.g., float, double).
+ */
+template <typename PT>
+class GeodesicDistanceCache
+{
+public:
+    using Field = std::shared_ptr<const std::vector<PT>>; ///< A distance field shared with the cache.
+
+    /**
+     * \brief Default memory budget of the cache, in bytes (256 MiB).
+     */
+    static constexpr std::size_t DEFAULT_MEMORY_BUDGET = std::size_t(256) << 20;
+
+    /**
+     * \brief Creates an empty cache.
+     *
+     * \param memoryBudget Maximum number of bytes of distance fields kept in the cache.
+     */
+    explicit GeodesicDistanceCache(std::size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    /**
+     * \brief Returns the distance field of a seed face, or nullptr if it is not cached.
+     *
+     * A hit marks the field as the most recently used one.
+     *
+     * \param seed The seed face of the distance field.
+     * \return The cached field, or nullptr.
+     */
+    Field get(FaceId seed);
+
+    /**
+     * \brief Stores the distance field of a seed face, evicting the least recently used ones if needed.
+     *
+     * A field larger than the whole budget is returned but not kept.
+     *
+     * \param seed The seed face of the distance field.
+     * \param distances The distance from the seed to every face.
+     * \return The stored field.
+     */
+    Field put(FaceId seed, std::vector<PT> distances);
+
+    /**
+     * \brief Returns the distance field of a seed face, computing and storing it on a miss.
+     *
+     * \param seed The seed face of the distance field.
+     * \param compute Function computing the distance field of a seed face.
+     * \return The cached or freshly computed field.
+     */
+    Field getOrCompute(FaceId seed, const std::function<std::vector<PT>(FaceId)> &compute);
+
+    /**
+     * \brief Removes all the fields from the cache, the statistics are kept.
+     */
+    void clear();
+
+    /**
+     * \brief Changes the memory budget, evicting fields if the cache no longer fits.
+     *
+     * \param memoryBudget Maximum number of bytes of distance fields kept in the cache.
+     */
+    void setMemoryBudget(std::size_t memoryBudget);
+
+    /**
+     * \brief Returns the memory budget of the cache, in bytes.
+     */
+    std::size_t getMemoryBudget() const;
+
+    /**
+     * \brief Returns the number of bytes of distance fields currently cached.
+     */
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * \brief Returns the number of cached distance fields.
+     */
+    std::size_t size() const;
+
+    /**
+     * \brief Returns the number of lookups that found their field in the cache.
+     */
+    std::size_t getHits() const;
+
+    /**
+     * \brief Returns the number of lookups that did not find their field in the cache.
+     */
+    std::size_t getMisses() const;
+
+private:
+    /**
+     * \brief A cached field with its seed, stored in the recency list.
+     */
+    struct Entry
+    {
+        FaceId seed;  ///< Seed face of the field.
+        Field field;  ///< Distance field.
+        std::size_t bytes; ///< Size of the field, in bytes.
+    };
+
+    std::list<Entry> entries;                                             ///< Cached fields, the most recently used first.
+    std::unordered_map<FaceId, typename std::list<Entry>::iterator> index; ///< Position of each seed in the recency list.
+    std::size_t memoryBudget;                                             ///< Maximum number of cached bytes.
+    std::size_t memoryUsage = 0;                                          ///< Number of cached bytes.
+    std::size_t hits = 0;                                                 ///< Number of lookups served by the cache.
+    std::size_t misses = 0;                                               ///< Number of lookups not served by the cache.
+    mutable std::mutex mutex;                                             ///< Protects all the members above.
+
+    /**
+     * \brief Evicts the least recently used fields until the cache fits its budget.
+     *
+     * Must be called with the mutex held.
+     */
+    void evict();
+};
+
+#endif // GEODESIC_DISTANCE_CACHE_HPP
@@ -8,6 +8,7 @@
 #include <cassert>
 #include "geometry/mesh/Mesh.hpp"
 #include "geometry/metrics/GeodesicDijkstraMetric.hpp"
+#include "geometry/metrics/HeatPrecomputeCache.hpp"
 
 #ifdef WIN32
 #include <windows.h>
@@ -72,14 +73,72 @@ public:
      */
     std::vector<PT> computeDistances(const FaceId startFace) const override;
 
+    /**
+     * \brief Computes the geodesic distances from several starting faces with one solve.
+     *
+     * The indicator vectors of all the sources are stacked as the columns of a dense matrix,
+     * so the heat flow and the Poisson step are multi right-hand side solves on the shared
+     * factorizations instead of one pair of triangular solves per source. The heat is
+     * released from all the vertices of a start face, and the vertex distances are turned
+     * into face distances by one product with the averaging operator.
+     *
+     * \param startFaces The faces of the mesh from which the geodesic distances will be calculated.
+     * \return One vector of distances from each starting face to all the faces.
+     */
+    std::vector<std::vector<PT>> computeDistancesBatch(const std::vector<FaceId> &startFaces) const;
+
+    /**
+     * \brief Snaps the centroids to their closest faces and computes their distance fields.
+     *
+     * The fields missing from the distance cache are computed together by `computeDistancesBatch`.
+     */
+    void setup() override;
+
 protected:
+    using Matrix = Eigen::Matrix<PT, Eigen::Dynamic, Eigen::Dynamic>;  ///< Dense matrix with one column per source.
+    using FaceAverageOperator = Eigen::SparseMatrix<PT, Eigen::RowMajor>; ///< Sparse F x V averaging operator.
+
+    /**
+     * \brief Dense matrices of a batched solve, kept between calls to reuse their memory.
+     */
+    struct Workspace
+    {
+        Matrix u0;             ///< Heat sources, one column per start face.
+        Matrix u;              ///< Heat flow.
+        Matrix uD;             ///< Heat flow with Dirichlet boundary conditions.
+        Matrix boundaryValues; ///< Known values and equality constraints of the solves.
+        Matrix gradU;          ///< Normalized gradient of the heat flow.
+        Matrix divX;           ///< Divergence of the normalized gradient.
+        Matrix D;              ///< Vertex distances.
+        Matrix faceDistances;  ///< Face distances, before the shift to the source face.
+    };
+
+    /**
+     * \brief Operator averaging the three vertex distances of every face, built once per metric.
+     */
+    std::shared_ptr<const FaceAverageOperator> faceAverage;
+
+    /**
+     * \brief Returns the workspace of the calling thread.
+     */
+    static Workspace &workspace();
+
     /**
      * \brief Heat geodesics data.
      *
      * Contains the results and information necessary for performing the heat geodesic
-     * calculations using the igl library.
+     * calculations using the igl library. It is shared through `HeatPrecomputeCache`
+     * with the other metrics built on the same mesh.
+     */
+    typename HeatPrecomputeCache<PT>::Data data_heat;
+
+    /**
+     * \brief Assembles the sparse operators of the heat method on a mesh.
+     *
+     * \param mesh The mesh.
+     * \return The gradient, divergence and system matrices of the mesh.
      */
-    igl::HeatGeodesicsData<PT> data_heat;
+    static typename HeatPrecomputeCache<PT>::Operators assembleOperators(Mesh &mesh);
 };
 
 #endif // GEODESIC_HEAT_METRIC_HPP
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef GEODESIC_VORONOI_METRIC_HPP
+#define GEODESIC_VORONOI_METRIC_HPP
+
+#include <queue>
+#include <tuple>
+#include <vector>
+#include <limits>
+#include "geometry/mesh/Mesh.hpp"
+#include "geometry/metrics/GeodesicDijkstraMetric.hpp"
+
+/**
+ * \class GeodesicVoronoiMetric
+ * \brief A geodesic metric that assigns the faces with a single multi-source Dijkstra.
+ *
+ * The Dijkstra metric computes one full distance field per centroid and then takes,
+ * for every face, the closest centroid: O(K N log N) time and O(K N) memory per iteration.
+ * This metric seeds one Dijkstra search with the faces of all the centroids at once and
+ * propagates the label of the seed together with the distance, so every face is settled
+ * by its closest seed directly (a geodesic Voronoi partition of the faces). An iteration
+ * costs O(N log N) time and O(N) memory, independently of the number of centroids.
+ *
+ * The edge weights are the same as the Dijkstra metric, so the resulting clusters are
+ * the same up to ties, which are broken in favour of the centroid with the lowest index.
+ *
+ * \tparam PT Type of the point (e.g., float, double)
+ * \tparam PD Dimension of the point (e.g., 3D)
+ */
+template <typename PT, std::size_t PD>
+class GeodesicVoronoiMetric : public GeodesicDijkstraMetric<PT, PD>
+{
+public:
+    /**
+     * \brief Constructor that initializes the Voronoi metric with a mesh and data points.
+     *
+     * \param mesh The mesh containing the geometry to calculate geodesics over.
+     * \param percentage_threshold The threshold value for geodesic distance calculations.
+     * \param data A collection of points (faces) to work with in the metric calculation.
+     */
+    GeodesicVoronoiMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data);
+
+    /**
+     * \brief Snaps every centroid to its closest face, which becomes its seed.
+     *
+     * Unlike the Dijkstra metric no distance field is computed here.
+     */
+    void setup() override;
+
+#ifdef USE_CUDA
+    /**
+     * \brief Fits the model on the CPU.
+     *
+     * A single multi-source search is already cheaper than the K searches of the
+     * GPU implementation, so this metric always runs on the CPU.
+     */
+    void fit_gpu() override;
+#endif
+
+protected:
+    /**
+     * \brief Assigns every face to its closest seed with a multi-source Dijkstra.
+     *
+     * \return The number of faces whose cluster changed.
+     */
+    size_t assignFaces() override;
+
+private:
+    std::vector<PT> seedDistances; /**< Distance of each face from its closest seed, reused across iterations. */
+    std::vector<int32_t> labels;   /**< Closest seed of each face, reused across iterations. */
+};
+
+#endif // GEODESIC_VORONOI_METRIC_HPP
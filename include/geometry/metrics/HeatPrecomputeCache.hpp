@@ -0,0 +1,182 @@
+#ifndef HEAT_PRECOMPUTE_CACHE_HPP
+#define HEAT_PRECOMPUTE_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <filesystem>
+
+#ifdef WIN32
+#include <windows.h>
+#undef max
+#undef min
+#endif
+#include <Eigen/Sparse>
+#include <igl/heat_geodesics.h>
+#include <igl/min_quad_with_fixed.h>
+#ifdef WIN32
+#undef max
+#undef min
+#endif
+
+/**
+ * \class HeatPrecomputeCache
+ * \brief Cache of the precomputed data of the heat method, keyed by mesh content hash.
+ *
+ * Building the operators of the heat method and factorizing its three linear systems
+ * dominates the construction of a GeodesicHeatMetric, and a pipeline usually segments
+ * the same mesh many times with different k and initializations. The cache keeps the
+ * factorized data of the last meshes in memory, shared by all the metrics built on a
+ * mesh with the same `Mesh::contentHash()`.
+ *
+ * When a directory is set, the sparse operators are also stored on disk, so later
+ * processes skip their assembly. The factorizations themselves are held by Eigen solver
+ * objects that cannot be serialized, so a disk hit still refactorizes the systems.
+ *
+ * All the methods are thread-safe, the operators are assembled and factorized outside the lock.
+ *
+ * \tparam PT The scalar type of the operators (e.g., float, double).
+ */
+template <typename PT>
+class HeatPrecomputeCache
+{
+public:
+    using Data = std::shared_ptr<const igl::HeatGeodesicsData<PT>>; ///< Precomputed data shared with the cache.
+
+    /**
+     * \brief Sparse operators of the heat method, from which the systems are factorized.
+     */
+    struct Operators
+    {
+        Eigen::SparseMatrix<PT> Grad;    ///< Gradient operator.
+        Eigen::SparseMatrix<PT> Div;     ///< Divergence operator.
+        Eigen::SparseMatrix<PT> Q;       ///< Matrix of the heat flow system, M - t L.
+        Eigen::SparseMatrix<PT> Poisson; ///< Matrix of the Poisson system, -L / 2.
+        Eigen::SparseMatrix<PT> Aeq;     ///< Diagonal of the mass matrix as a row, constraint of the Poisson system.
+        Eigen::VectorXi b;               ///< Boundary vertices, fixed in the Dirichlet heat flow.
+        int ng = 0;                      ///< Number of gradient components per face.
+    };
+
+    /**
+     * \brief Default number of meshes kept in memory.
+     */
+    static constexpr std::size_t DEFAULT_CAPACITY = 4;
+
+    /**
+     * \brief Returns the cache shared by all the heat metrics of the process.
+     */
+    static HeatPrecomputeCache &global();
+
+    /**
+     * \brief Creates an empty cache without a disk directory.
+     *
+     * \param capacity Maximum number of meshes kept in memory.
+     */
+    explicit HeatPrecomputeCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * \brief Returns the precomputed data of a mesh, or nullptr if it is not in memory.
+     *
+     * \param key The content hash of the mesh.
+     * \return The cached data, or nullptr.
+     */
+    Data get(uint64_t key);
+
+    /**
+     * \brief Returns the precomputed data of a mesh, building it on a miss.
+     *
+     * On a miss the operators are read from the disk directory if possible, otherwise
+     * they are assembled and written there. The systems are then factorized and the
+     * data is kept in memory.
+     *
+     * \param key The content hash of the mesh.
+     * \param assemble Function assembling the operators of the mesh.
+     * \return The cached or freshly computed data.
+     */
+    Data getOrCompute(uint64_t key, const std::function<Operators()> &assemble);
+
+    /**
+     * \brief Sets the directory where the operators are stored, an empty path disables the disk tier.
+     *
+     * \param directory The directory of the operator files, created when needed.
+     */
+    void setDirectory(const std::filesystem::path &directory);
+
+    /**
+     * \brief Returns the directory of the operator files, empty if the disk tier is disabled.
+     */
+    std::filesystem::path getDirectory() const;
+
+    /**
+     * \brief Changes the number of meshes kept in memory, evicting the oldest ones if needed.
+     *
+     * \param capacity Maximum number of meshes kept in memory.
+     */
+    void setCapacity(std::size_t capacity);
+
+    /**
+     * \brief Returns the number of meshes whose data is in memory.
+     */
+    std::size_t size() const;
+
+    /**
+     * \brief Removes all the data from memory, the files on disk are kept.
+     */
+    void clear();
+
+    /**
+     * \brief Factorizes the Neumann, Dirichlet and Poisson systems of the heat method.
+     *
+     * \param operators The operators of a mesh.
+     * \return The data used by `igl::heat_geodesics_solve`.
+     * \throws std::runtime_error If one of the factorizations fails.
+     */
+    static Data factorize(const Operators &operators);
+
+    /**
+     * \brief Writes the operators of a mesh to a binary file.
+     *
+     * The file is written next to its final path and renamed, so a concurrent reader
+     * never sees it half written.
+     *
+     * \param path The path of the file.
+     * \param key The content hash of the mesh, stored in the file.
+     * \param operators The operators to write.
+     * \return True if the file was written.
+     */
+    static bool saveOperators(const std::filesystem::path &path, uint64_t key, const Operators &operators);
+
+    /**
+     * \brief Reads the operators of a mesh from a binary file.
+     *
+     * \param path The path of the file.
+     * \param key The content hash of the mesh, compared with the one stored in the file.
+     * \param operators The operators read from the file.
+     * \return False if the file is missing, truncated, from another version or for another mesh.
+     */
+    static bool loadOperators(const std::filesystem::path &path, uint64_t key, Operators &operators);
+
+private:
+    std::list<std::pair<uint64_t, Data>> entries; ///< Cached data, the most recently used first.
+    std::filesystem::path directory;              ///< Directory of the operator files, empty if disabled.
+    std::size_t capacity;                         ///< Maximum number of entries.
+    mutable std::mutex mutex;                     ///< Protects all the members above.
+
+    /**
+     * \brief Path of the operator file of a mesh in the directory.
+     */
+    static std::filesystem::path operatorsPath(const std::filesystem::path &directory, uint64_t key);
+
+    /**
+     * \brief Evicts the least recently used entries until the cache fits its capacity.
+     *
+     * Must be called with the mutex held.
+     */
+    void evict();
+};
+
+#endif // HEAT_PRECOMPUTE_CACHE_HPP
@@ -9,6 +9,7 @@
 
 #include "geometry/point/CentroidPoint.hpp"
 #include "geometry/point/Point.hpp"
+#include "geometry/point/PointSet.hpp"
 
 /**
  * \class Metric
@@ -95,6 +96,13 @@ public:
      */
     void setPoints(std::vector<Point<PT, PD>> data);
 
+    /**
+     * \brief Sets the data points for the metric from a structure-of-arrays point set.
+     * 
+     * \param points The point set used in the metric calculation.
+     */
+    void setPoints(PointSet<PT, PD> points);
+
     /**
      * \brief Gets the data points used for the metric calculations.
      * 
@@ -102,6 +110,33 @@ public:
      */
     virtual std::vector<Point<PT, PD>>& getPoints() = 0;
 
+    /**
+     * \brief Gets the structure-of-arrays copy of the data points used in the hot path.
+     * 
+     * The labels of the point set hold the index of the centroid assigned to each point.
+     * 
+     * \return A reference to the point set.
+     */
+    PointSet<PT, PD>& getPointSet();
+
+    /**
+     * \brief Gets the cluster assignment of every data point.
+     * 
+     * \return A dense vector holding, for each point, the index of its centroid in the
+     * centroids vector, or `PointSet::UNASSIGNED` if the point has not been assigned yet.
+     */
+    const std::vector<int32_t>& getAssignments() const;
+
+    /**
+     * \brief Gets the centroid assigned to a data point.
+     * 
+     * Compatibility accessor for the callers that need the centroid itself rather than its index.
+     * 
+     * \param index The index of the data point.
+     * \return A pointer to the assigned centroid, or nullptr if the point is not assigned.
+     */
+    const CentroidPoint<PT, PD>* getAssignedCentroid(std::size_t index) const;
+
     #ifdef USE_CUDA
     /**
      * \brief Fits the KMeans algorithm on the GPU.
@@ -125,6 +160,7 @@ protected:
     std::vector<CentroidPoint<PT, PD>> oldCentroids; /**< Stores the old centroids for comparison. */
     std::vector<CentroidPoint<PT, PD>> *centroids; /**< Pointer to the vector of centroids. */
     std::vector<Point<PT, PD>> data; /**< Stores the data points used in the metric calculation. */
+    PointSet<PT, PD> pointSet; /**< Structure-of-arrays copy of `data` with the cluster labels. */
 
     /**
      * \brief Stores the centroids after the fitting process.
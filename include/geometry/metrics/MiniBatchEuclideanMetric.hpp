@@ -0,0 +1,168 @@
+#ifndef MINI_BATCH_EUCLIDEAN_METRIC_HPP
+#define MINI_BATCH_EUCLIDEAN_METRIC_HPP
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#include "geometry/metrics/Metric.hpp"
+#include "geometry/point/BatchSource.hpp"
+
+/**
+ * \class MiniBatchEuclideanMetric
+ * \brief Euclidean k-means updating the centroids from small random batches of points.
+ *
+ * Each iteration of the full algorithm visits every point, so its cost grows with the
+ * size of the dataset. The mini-batch variant (Sculley, 2010) assigns a batch of points
+ * to the closest centroids and moves every centroid toward the mean of its points in
+ * the batch by a learning rate. By default the rate of a centroid is the number of its
+ * points in the batch over the number of points it has received so far, which makes
+ * each centroid the running mean of its points. The cost of an iteration only depends
+ * on the batch size and the number of centroids.
+ *
+ * The points are either kept in memory, with the batches drawn uniformly at random, or
+ * read from a `BatchSource`. In the latter case only a sample of the source is kept:
+ * it is returned by `getPoints()` to initialize the centroids and labeled at the end
+ * of the fit, and `assignPoints` labels the rest of the data chunk by chunk.
+ *
+ * The fit stops when the average drift of the centroids, smoothed over the last
+ * iterations since a single batch is noisy, falls below the threshold.
+ *
+ * \tparam PT Type of the point (e.g., float, double)
+ * \tparam PD Dimension of the point (e.g., 2D, 3D)
+ */
+template <typename PT, std::size_t PD>
+class MiniBatchEuclideanMetric : public Metric<PT, PD>
+{
+public:
+    /**
+     * \brief Learning rate of a centroid, called once per centroid and iteration.
+     *
+     * Receives the iteration number, the number of points of the batch assigned to the
+     * centroid and the number of points assigned to it since the beginning of the fit
+     * (batch included). Returns the fraction of the way toward the batch mean the
+     * centroid moves.
+     */
+    using LearningRate = std::function<PT(std::size_t iteration, std::size_t batchCount, std::size_t totalCount)>;
+
+    /**
+     * \brief Default maximum number of batches of a fit.
+     */
+    static constexpr std::size_t DEFAULT_MAX_ITERATIONS = 1000;
+
+    /**
+     * \brief Weight of the last iteration in the smoothed drift of the centroids.
+     */
+    static constexpr double DRIFT_SMOOTHING = 0.1;
+
+    /**
+     * \brief Constructor that keeps the data points in memory.
+     *
+     * \param data The data points used for the metric computation.
+     * \param batchSize The number of points of each batch.
+     * \param threshold The smoothed average drift of the centroids under which the fit stops.
+     */
+    MiniBatchEuclideanMetric(std::vector<Point<PT, PD>> data, std::size_t batchSize, double threshold);
+
+    /**
+     * \brief Constructor that reads the data points from a source.
+     *
+     * The first `sampleSize` points of the source are kept as the sample returned by
+     * `getPoints()`, then the source is rewound.
+     *
+     * \param source The source of the batches.
+     * \param batchSize The number of points of each batch.
+     * \param threshold The smoothed average drift of the centroids under which the fit stops.
+     * \param sampleSize The number of points kept in memory, `batchSize` if 0.
+     */
+    MiniBatchEuclideanMetric(std::shared_ptr<BatchSource<PT, PD>> source, std::size_t batchSize, double threshold, std::size_t sampleSize = 0);
+
+    /**
+     * \brief Default learning rate, the points of the batch over the points of the centroid.
+     */
+    static PT perCenterLearningRate(std::size_t iteration, std::size_t batchCount, std::size_t totalCount);
+
+    /**
+     * \brief Setup method, nothing to prepare for this metric.
+     */
+    void setup() override;
+
+    /**
+     * \brief Fits the centroids on mini-batches, then labels the points kept in memory.
+     */
+    void fit_cpu() override;
+
+#ifdef USE_CUDA
+    /**
+     * \brief Same as `fit_cpu`, the batches are too small to be worth a transfer to the GPU.
+     */
+    void fit_gpu() override;
+#endif
+
+    /**
+     * \brief Returns the data points kept in memory, the sample of the source if any.
+     *
+     * \return A reference to the vector of data points.
+     */
+    std::vector<Point<PT, PD>> &getPoints() override;
+
+    /**
+     * \brief Labels every point of a set with the index of its closest centroid.
+     *
+     * \param points The points to label, e.g. a chunk of the source.
+     */
+    void assignPoints(PointSet<PT, PD> &points) const;
+
+    /**
+     * \brief Replaces the learning rate schedule.
+     *
+     * \param learningRate The new schedule, `perCenterLearningRate` by default.
+     */
+    void setLearningRate(LearningRate learningRate) { this->learningRate = std::move(learningRate); }
+
+    /**
+     * \brief Sets the maximum number of batches of a fit.
+     */
+    void setMaxIterations(std::size_t maxIterations) { this->maxIterations = maxIterations; }
+
+    /**
+     * \brief Seeds the generator drawing the batches from the points in memory.
+     */
+    void setSeed(uint64_t seed) { generator.seed(seed); }
+
+    /**
+     * \brief Returns the number of batches processed by the last fit.
+     */
+    std::size_t getIterations() const { return iterations; }
+
+protected:
+    /**
+     * \brief Nothing to store, the metric has no mesh.
+     */
+    void storeCentroids() override;
+
+private:
+    std::shared_ptr<BatchSource<PT, PD>> source; /**< Source of the batches, nullptr to sample the points in memory. */
+    std::size_t batchSize; /**< Number of points of each batch. */
+    double treshold; /**< Smoothed average drift of the centroids under which the fit stops. */
+    std::size_t maxIterations = DEFAULT_MAX_ITERATIONS; /**< Maximum number of batches of a fit. */
+    LearningRate learningRate = perCenterLearningRate; /**< Learning rate schedule of the centroids. */
+    std::mt19937_64 generator; /**< Generator of the batches drawn from the points in memory. */
+    std::vector<std::size_t> counts; /**< Number of points assigned to each centroid since the beginning of the fit. */
+    std::size_t iterations = 0; /**< Number of batches processed by the last fit. */
+
+    /**
+     * \brief Fills the next batch, from the source or from the points in memory.
+     *
+     * A source at the end of its pass is rewound once.
+     *
+     * \param batch The point set receiving the batch.
+     * \return The number of points of the batch, 0 if there is no data.
+     */
+    std::size_t nextBatch(PointSet<PT, PD> &batch);
+};
+
+#endif // MINI_BATCH_EUCLIDEAN_METRIC_HPP
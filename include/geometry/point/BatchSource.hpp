@@ -0,0 +1,42 @@
+#ifndef BATCH_SOURCE_HPP
+#define BATCH_SOURCE_HPP
+
+#include <cstddef>
+
+#include "geometry/point/PointSet.hpp"
+
+/**
+ * \class BatchSource
+ * \brief Interface of a reader handing out the points of a dataset a batch at a time.
+ *
+ * Used by the mini-batch metric to cluster datasets that do not fit in memory: only
+ * the current batch is materialized. A source reads the data in its own order, one
+ * pass after the other; a source reading a file in chunks should shuffle or
+ * interleave them if the file is sorted, since the batches are expected to be
+ * representative samples of the data.
+ *
+ * \tparam PT The type used for the coordinates (e.g., float, double).
+ * \tparam PD The number of dimensions of the points.
+ */
+template <typename PT, std::size_t PD>
+class BatchSource
+{
+public:
+    virtual ~BatchSource() = default;
+
+    /**
+     * \brief Reads the next batch of points.
+     *
+     * \param batchSize The maximum number of points to read.
+     * \param batch The point set receiving the points, resized to the number of points read.
+     * \return The number of points read, 0 at the end of a pass over the data.
+     */
+    virtual std::size_t nextBatch(std::size_t batchSize, PointSet<PT, PD> &batch) = 0;
+
+    /**
+     * \brief Restarts the source from the beginning of the data.
+     */
+    virtual void rewind() = 0;
+};
+
+#endif // BATCH_SOURCE_HPP
@@ -0,0 +1,170 @@
+#ifndef POINTSET_HPP
+#define POINTSET_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "geometry/point/Point.hpp"
+
+/**
+ * \class PointSet
+ * \brief Structure-of-arrays container for the points used in the clustering hot path.
+ *
+ * A `Point<PT, PD>` carries a vtable, an id and a shared pointer to its centroid, so
+ * a vector of points is roughly twice as large as the coordinates it stores. The
+ * `PointSet` stores the coordinates as one contiguous array per dimension and the
+ * cluster assignment of every point as a dense `int32_t` label array. The index of a
+ * point in the set is its identifier.
+ *
+ * \tparam PT The type used for the coordinates (e.g., float, double).
+ * \tparam PD The number of dimensions of the points (e.g., 2 for 2D, 3 for 3D).
+ */
+template <typename PT, std::size_t PD>
+class PointSet
+{
+public:
+    /**
+     * \brief Label of a point that has not been assigned to any cluster.
+     */
+    static constexpr int32_t UNASSIGNED = -1;
+
+    /**
+     * \brief Default constructor, creates an empty set.
+     */
+    PointSet() = default;
+
+    /**
+     * \brief Creates a set of `size` points with all coordinates set to zero.
+     *
+     * \param size The number of points in the set.
+     */
+    explicit PointSet(std::size_t size);
+
+    /**
+     * \brief Creates a set from a vector of points.
+     *
+     * The coordinates are copied into the per-dimension arrays and every label is
+     * set to `UNASSIGNED`.
+     *
+     * \param points The points to copy into the set.
+     */
+    explicit PointSet(const std::vector<Point<PT, PD>> &points);
+
+    /**
+     * \brief Returns the number of points in the set.
+     */
+    std::size_t size() const { return labels.size(); }
+
+    /**
+     * \brief Returns true if the set contains no points.
+     */
+    bool empty() const { return labels.empty(); }
+
+    /**
+     * \brief Resizes the set, new points are zero-initialized and unassigned.
+     *
+     * \param size The new number of points.
+     */
+    void resize(std::size_t size);
+
+    /**
+     * \brief Reserves storage for at least `size` points.
+     *
+     * \param size The number of points to reserve.
+     */
+    void reserve(std::size_t size);
+
+    /**
+     * \brief Removes all the points from the set.
+     */
+    void clear();
+
+    /**
+     * \brief Appends a point at the end of the set.
+     *
+     * \param point The point to append, its label is set to `UNASSIGNED`.
+     */
+    void addPoint(const Point<PT, PD> &point);
+
+    /**
+     * \brief Returns the coordinate `dim` of the point `i`.
+     */
+    PT &operator()(std::size_t i, std::size_t dim) { return coords[dim][i]; }
+
+    /**
+     * \brief Returns the coordinate `dim` of the point `i`.
+     */
+    const PT &operator()(std::size_t i, std::size_t dim) const { return coords[dim][i]; }
+
+    /**
+     * \brief Returns the contiguous array holding the coordinate `dim` of every point.
+     *
+     * \param dim The dimension to access.
+     * \return A pointer to `size()` coordinates.
+     */
+    PT *data(std::size_t dim) { return coords[dim].data(); }
+
+    /**
+     * \brief Returns the contiguous array holding the coordinate `dim` of every point.
+     *
+     * \param dim The dimension to access.
+     * \return A pointer to `size()` coordinates.
+     */
+    const PT *data(std::size_t dim) const { return coords[dim].data(); }
+
+    /**
+     * \brief Builds a `Point` from the coordinates of the point `i`.
+     *
+     * \param i The index of the point.
+     * \return A point whose id is `i`.
+     */
+    Point<PT, PD> getPoint(std::size_t i) const;
+
+    /**
+     * \brief Overwrites the coordinates of the point `i`.
+     *
+     * \param i The index of the point.
+     * \param point The point to copy the coordinates from.
+     */
+    void setPoint(std::size_t i, const Point<PT, PD> &point);
+
+    /**
+     * \brief Converts the set back into a vector of points (array-of-structures).
+     *
+     * \return A vector of points, the id of each point is its index in the set.
+     */
+    std::vector<Point<PT, PD>> toPoints() const;
+
+    /**
+     * \brief Returns the cluster label of the point `i`, or `UNASSIGNED`.
+     */
+    int32_t getLabel(std::size_t i) const { return labels[i]; }
+
+    /**
+     * \brief Sets the cluster label of the point `i`.
+     */
+    void setLabel(std::size_t i, int32_t label) { labels[i] = label; }
+
+    /**
+     * \brief Returns the dense array of cluster labels.
+     */
+    std::vector<int32_t> &getLabels() { return labels; }
+
+    /**
+     * \brief Returns the dense array of cluster labels.
+     */
+    const std::vector<int32_t> &getLabels() const { return labels; }
+
+    /**
+     * \brief Marks every point as unassigned.
+     */
+    void resetLabels();
+
+private:
+    std::array<std::vector<PT>, PD> coords; ///< One contiguous coordinate array per dimension.
+    std::vector<int32_t> labels;            ///< Cluster label of each point.
+};
+
+#endif // POINTSET_HPP
@@ -0,0 +1,140 @@
+#ifndef POINTSET_CACHE_HPP
+#define POINTSET_CACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#include "geometry/point/PointSet.hpp"
+#include "utils/BinaryCache.hpp"
+#include "utils/MappedFile.hpp"
+
+/**
+ * \class PointSetCache
+ * \brief Versioned binary format of a point set.
+ *
+ * A `.kpts` file stores a header (magic number, format version, size of the scalar
+ * type, number of dimensions, number of points and stamp of the source file) followed
+ * by one array of coordinates per dimension, the layout of `PointSet`. Loading maps
+ * the file and copies the columns, without parsing any text.
+ */
+class PointSetCache
+{
+public:
+    /**
+     * \brief Extension of the cache files.
+     */
+    static constexpr const char *EXTENSION = ".kpts";
+
+    /**
+     * \brief Version of the format, incremented when the layout changes.
+     */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * \brief Writes a point set to a cache file.
+     *
+     * \param points The points to write, the labels are not stored.
+     * \param path The path of the cache file.
+     * \param source The stamp of the source file of the points, zero if there is none.
+     * \return True if the file was written.
+     */
+    template <typename PT, std::size_t PD>
+    static bool save(const PointSet<PT, PD> &points, const std::filesystem::path &path, const BinaryCache::SourceStamp &source = {})
+    {
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.scalarSize = sizeof(PT);
+        header.dimensions = PD;
+        header.numPoints = points.size();
+        header.sourceSize = source.size;
+        header.sourceTime = source.time;
+
+        return BinaryCache::writeAtomically(path, [&](std::ofstream &out)
+        {
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            for (std::size_t d = 0; d < PD; ++d)
+            {
+                BinaryCache::writeArray(out, points.data(d), sizeof(PT) * points.size());
+            }
+            return static_cast<bool>(out);
+        });
+    }
+
+    /**
+     * \brief Reads a point set from a cache file.
+     *
+     * \param path The path of the cache file.
+     * \param points The set receiving the points, all unassigned, only modified on success.
+     * \param source If not null, the cache is rejected unless it was written for this source stamp.
+     * \return False if the file is missing, stale, truncated or written for another type or dimension.
+     */
+    template <typename PT, std::size_t PD>
+    static bool load(const std::filesystem::path &path, PointSet<PT, PD> &points, const BinaryCache::SourceStamp *source = nullptr)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            return false;
+        }
+
+        try
+        {
+            MappedFile file(path.string());
+            Header header;
+            if (file.size() < sizeof(Header))
+            {
+                return false;
+            }
+            std::memcpy(&header, file.data(), sizeof(Header));
+            if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+                || header.scalarSize != sizeof(PT) || header.dimensions != PD)
+            {
+                return false;
+            }
+            if (source != nullptr && !BinaryCache::isFresh(path, {header.sourceSize, header.sourceTime}, *source))
+            {
+                return false;
+            }
+            if (header.numPoints > (file.size() - sizeof(Header)) / sizeof(PT)
+                || sizeof(Header) + PD * BinaryCache::padded(sizeof(PT) * header.numPoints) != file.size())
+            {
+                return false;
+            }
+
+            PointSet<PT, PD> loaded(header.numPoints);
+            const char *cursor = file.data() + sizeof(Header);
+            for (std::size_t d = 0; d < PD; ++d)
+            {
+                cursor = BinaryCache::readArray(cursor, loaded.data(d), sizeof(PT) * header.numPoints);
+            }
+            points = std::move(loaded);
+            return true;
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+    }
+
+private:
+    static constexpr char MAGIC[4] = {'K', 'P', 'T', 'S'};
+
+    /**
+     * \brief Fixed-size header at the start of a .kpts file.
+     */
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t scalarSize;
+        uint32_t dimensions;
+        uint64_t numPoints;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+    };
+    static_assert(sizeof(Header) == 40, "The header must not contain padding");
+};
+
+#endif // POINTSET_CACHE_HPP
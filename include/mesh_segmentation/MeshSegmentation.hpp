@@ -12,6 +12,7 @@
 #include "geometry/mesh/Mesh.hpp"
 #include "geometry/metrics/GeodesicDijkstraMetric.hpp"
 #include "geometry/metrics/GeodesicHeatMetric.hpp"
+#include "geometry/metrics/GeodesicVoronoiMetric.hpp"
 #include "clustering/KMeans.hpp"
 
 /**
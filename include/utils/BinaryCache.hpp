@@ -0,0 +1,147 @@
+#ifndef BINARY_CACHE_HPP
+#define BINARY_CACHE_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+#include <system_error>
+
+/**
+ * \class BinaryCache
+ * \brief Helpers shared by the binary caches written next to the text inputs.
+ *
+ * A cache file stores the size and modification time of its source file, so a cache
+ * older than its source is detected without reading the source. The files are
+ * written next to their final path and renamed, so a concurrent reader never sees
+ * them half written. The arrays of a cache file are padded to 8 bytes, the host byte
+ * order is assumed.
+ */
+class BinaryCache
+{
+public:
+    /**
+     * \brief Size and modification time of a source file.
+     */
+    struct SourceStamp
+    {
+        uint64_t size = 0; ///< Size of the source, in bytes.
+        int64_t time = 0;  ///< Modification time of the source, in file clock ticks.
+
+        bool operator==(const SourceStamp &other) const { return size == other.size && time == other.time; }
+        bool operator!=(const SourceStamp &other) const { return !(*this == other); }
+    };
+
+    /**
+     * \brief Returns the stamp of a file, or false if the file cannot be read.
+     */
+    static bool stamp(const std::filesystem::path &path, SourceStamp &stamp)
+    {
+        std::error_code error;
+        const uintmax_t size = std::filesystem::file_size(path, error);
+        if (error)
+        {
+            return false;
+        }
+        const auto time = std::filesystem::last_write_time(path, error);
+        if (error)
+        {
+            return false;
+        }
+        stamp.size = static_cast<uint64_t>(size);
+        stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    /**
+     * \brief Tells whether a cache written for a source stamp is still valid.
+     *
+     * The stored stamp must match the current one, and the cache must be strictly newer
+     * than the source: a source rewritten with the same size within the timestamp
+     * granularity of the file system, right after the cache was written, would otherwise
+     * keep the same stamp.
+     *
+     * \param cache The path of the cache file.
+     * \param stored The stamp stored in the cache.
+     * \param current The current stamp of the source.
+     */
+    static bool isFresh(const std::filesystem::path &cache, const SourceStamp &stored, const SourceStamp &current)
+    {
+        std::error_code error;
+        const auto time = std::filesystem::last_write_time(cache, error);
+        return !error && stored == current && static_cast<int64_t>(time.time_since_epoch().count()) > current.time;
+    }
+
+    /**
+     * \brief Returns the path of the cache of a source file, the source path followed by an extension.
+     */
+    static std::filesystem::path cachePath(const std::filesystem::path &source, const std::string &extension)
+    {
+        std::filesystem::path path = source;
+        path += extension;
+        return path;
+    }
+
+    /**
+     * \brief Rounds a size up to a multiple of 8 bytes.
+     */
+    static std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t(7); }
+
+    /**
+     * \brief Writes an array followed by the padding to 8 bytes.
+     */
+    static void writeArray(std::ofstream &out, const void *data, std::size_t bytes)
+    {
+        static const char zeros[8] = {};
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+        out.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+    }
+
+    /**
+     * \brief Copies an array out of a mapped file and moves the cursor past its padding.
+     */
+    static const char *readArray(const char *cursor, void *data, std::size_t bytes)
+    {
+        if (bytes > 0)
+        {
+            std::memcpy(data, cursor, bytes);
+        }
+        return cursor + padded(bytes);
+    }
+
+    /**
+     * \brief Writes a file through a temporary file renamed at the end.
+     *
+     * \param path The final path of the file.
+     * \param write Function writing the content, returns false on failure.
+     * \return True if the file was written.
+     */
+    static bool writeAtomically(const std::filesystem::path &path, const std::function<bool(std::ofstream &)> &write)
+    {
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp";
+        {
+            std::ofstream out(temporaryPath, std::ios::binary);
+            if (!out || !write(out) || !out.flush())
+            {
+                out.close();
+                std::error_code error;
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif // BINARY_CACHE_HPP
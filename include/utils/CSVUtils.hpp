@@ -1,32 +1,49 @@
 #ifndef CSVUTILS_HPP
 #define CSVUTILS_HPP
 
-#include <iostream>
-#include <vector>
+#include <omp.h>
+#include <array>
+#include <cstdio>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <algorithm>
 #include <stdexcept>
-#include "csv.hpp"
+
 #include "geometry/point/Point.hpp"
+#include "geometry/point/PointSet.hpp"
+#include "geometry/point/BatchSource.hpp"
+#include "geometry/point/PointSetCache.hpp"
+#include "utils/MappedFile.hpp"
 
 /**
  * \class CSVUtils
  * \brief A static utility class for handling CSV file operations.
- * 
- * The `CSVUtils` class provides a static method to read a CSV file and convert 
- * its rows into `Point` objects. This enables easy integration of CSV data 
- * into geometric computations.
+ *
+ * The `CSVUtils` class reads numeric CSV files, one point per row and one coordinate
+ * per column, optionally preceded by a header row. The file is memory-mapped and
+ * split into chunks at line boundaries, the chunks are parsed in parallel directly
+ * into the arrays of a `PointSet`.
  */
 class CSVUtils
 {
 public:
+    /**
+     * \brief Minimum size of the chunks parsed by one thread, in bytes.
+     */
+    static constexpr std::size_t MIN_CHUNK_BYTES = std::size_t(1) << 16;
+
     /**
      * \brief Reads a CSV file and converts its rows into `Point` objects.
-     * 
-     * This static method processes a CSV file where each row corresponds to a 
-     * `Point` in a multi-dimensional space. The method ensures that each row 
-     * has the correct number of dimensions and converts the data into numerical 
+     *
+     * This static method processes a CSV file where each row corresponds to a
+     * `Point` in a multi-dimensional space. The method ensures that each row
+     * has the correct number of dimensions and converts the data into numerical
      * values of type `PT`.
-     * 
+     *
      * \tparam PT The data type of the point coordinates (e.g., `float`, `double`, `int`).
      * \tparam PD The number of dimensions of each point (e.g., 2 for 2D, 3 for 3D).
      * \param filepath The path to the CSV file.
@@ -36,47 +53,447 @@ public:
     template <typename PT, std::size_t PD>
     static std::vector<Point<PT, PD>> readCSV(const std::string &filepath)
     {
-        std::vector<Point<PT, PD>> points; // Collection to store the parsed Points
+        return readPointSet<PT, PD>(filepath).toPoints();
+    }
 
+    /**
+     * \brief Reads a CSV file into a structure-of-arrays point set.
+     *
+     * The rows are counted chunk by chunk in parallel, the point set is allocated once,
+     * then every chunk parses its rows at its offset. Blank lines are skipped.
+     *
+     * \tparam PT The data type of the point coordinates (e.g., `float`, `double`).
+     * \tparam PD The number of dimensions of each point.
+     * \param filepath The path to the CSV file.
+     * \return The points of the file, in the order of the rows, all unassigned.
+     * \throws std::runtime_error If the file cannot be opened or a row is not made of PD numbers.
+     */
+    template <typename PT, std::size_t PD>
+    static PointSet<PT, PD> readPointSet(const std::string &filepath)
+    {
         try
         {
-            // Create a CSV reader object to process the file
-            csv::CSVReader reader(filepath);
+            MappedFile file(filepath);
+            file.adviseSequential();
+            const char *end = file.data() + file.size();
+            const char *begin = skipHeader(file.data(), end);
+
+            // Chunks of at least MIN_CHUNK_BYTES, a few per thread to balance the load
+            const std::size_t bytes = static_cast<std::size_t>(end - begin);
+            const std::size_t numChunks = std::max<std::size_t>(1, std::min<std::size_t>(bytes / MIN_CHUNK_BYTES, 4 * omp_get_max_threads()));
+            std::vector<const char *> bounds(numChunks + 1, end);
+            bounds[0] = begin;
+            for (std::size_t c = 1; c < numChunks; ++c)
+            {
+                const char *cursor = std::max(begin + bytes * c / numChunks, bounds[c - 1]);
+                bounds[c] = cursor == begin || cursor[-1] == '\n' ? cursor : nextLine(cursor, end);
+            }
 
-            // Iterate through each row in the CSV file
-            for (csv::CSVRow &row : reader)
+            std::vector<std::size_t> offsets(numChunks + 1, 0);
+            #pragma omp parallel for schedule(dynamic, 1)
+            for (std::size_t c = 0; c < numChunks; ++c)
             {
-                // Ensure the row has exactly PD columns (matches the number of dimensions)
-                if (row.size() != PD)
+                std::size_t rows = 0;
+                for (const char *line = bounds[c], *next; line < bounds[c + 1]; line = next)
                 {
-                    throw std::runtime_error("Row does not have the correct number of dimensions: " + std::to_string(row.size()));
+                    rows += !isBlank(line, lineEnd(line, end, next));
                 }
+                offsets[c + 1] = rows;
+            }
+            for (std::size_t c = 0; c < numChunks; ++c)
+            {
+                offsets[c + 1] += offsets[c];
+            }
 
-                // Parse the row into an array of coordinates
-                std::array<PT, PD> coordinates;
-                for (std::size_t i = 0; i < PD; ++i)
+            PointSet<PT, PD> points(offsets[numChunks]);
+            std::size_t firstInvalidRow = offsets[numChunks];
+            #pragma omp parallel for schedule(dynamic, 1) reduction(min : firstInvalidRow)
+            for (std::size_t c = 0; c < numChunks; ++c)
+            {
+                std::size_t row = offsets[c];
+                for (const char *line = bounds[c], *next; line < bounds[c + 1]; line = next)
                 {
-                    try
+                    const char *last = lineEnd(line, end, next);
+                    if (isBlank(line, last))
                     {
-                        coordinates[i] = row[i].get<PT>(); // Convert each CSV value to the required type
+                        continue;
                     }
-                    catch (const std::exception &e)
+                    if (!parseRow(line, last, points, row))
                     {
-                        throw std::runtime_error("Non-numeric data found in CSV");
+                        firstInvalidRow = std::min(firstInvalidRow, row);
+                        break;
                     }
+                    row++;
                 }
+            }
 
-                // Create a Point using the parsed coordinates and add it to the collection
-                points.emplace_back(coordinates);
+            if (firstInvalidRow < points.size())
+            {
+                throw std::runtime_error("Row " + std::to_string(firstInvalidRow + 1) + " is not made of " + std::to_string(PD) + " numeric columns");
             }
+            return points;
         }
         catch (const std::exception &e)
         {
             throw std::runtime_error(std::string("Error reading CSV: ") + e.what());
         }
+    }
+
+    /**
+     * \brief Reads a CSV file through its binary cache.
+     *
+     * The cache `<filepath>.kpts` is read if it is up to date; otherwise the CSV file is
+     * parsed with `readPointSet` and the cache written next to it, best effort.
+     *
+     * \tparam PT The data type of the point coordinates (e.g., `float`, `double`).
+     * \tparam PD The number of dimensions of each point.
+     * \param filepath The path to the CSV file.
+     * \return The points of the file, in the order of the rows, all unassigned.
+     * \throws std::runtime_error If the file cannot be opened or a row is not made of PD numbers.
+     */
+    template <typename PT, std::size_t PD>
+    static PointSet<PT, PD> readPointSetCached(const std::string &filepath)
+    {
+        BinaryCache::SourceStamp stamp;
+        const bool cached = BinaryCache::stamp(filepath, stamp);
+        const std::filesystem::path cachePath = BinaryCache::cachePath(filepath, PointSetCache::EXTENSION);
 
+        PointSet<PT, PD> points;
+        if (cached && PointSetCache::load(cachePath, points, &stamp))
+        {
+            return points;
+        }
+        points = readPointSet<PT, PD>(filepath);
+        if (cached)
+        {
+            PointSetCache::save(points, cachePath, stamp);
+        }
         return points;
     }
+
+    /**
+     * \brief Parses a decimal number, skipping the spaces before it.
+     *
+     * Numbers with at most 19 significant digits and a decimal exponent within
+     * [-22, 22] are converted exactly with a single floating point operation (Clinger's
+     * fast path). The other ones, and the special values, fall back to `std::strtod`.
+     *
+     * \param cursor The position to parse from, moved after the number on success.
+     * \param end The end of the text.
+     * \param value The parsed number.
+     * \return False if there is no valid number at the cursor.
+     */
+    static bool parseNumber(const char *&cursor, const char *end, double &value)
+    {
+        static constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+        const char *p = cursor;
+        while (p < end && (*p == ' ' || *p == '\t'))
+        {
+            p++;
+        }
+        const char *token = p;
+
+        const bool negative = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            p++;
+        }
+
+        uint64_t mantissa = 0;
+        int significantDigits = 0, exponent = 0;
+        bool anyDigit = false, truncated = false;
+        auto readDigit = [&](bool fraction)
+        {
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                significantDigits += mantissa != 0;
+                exponent -= fraction;
+            }
+            else
+            {
+                truncated = true;
+                exponent += !fraction;
+            }
+            anyDigit = true;
+            p++;
+        };
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            readDigit(false);
+        }
+        if (p < end && *p == '.')
+        {
+            p++;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                readDigit(true);
+            }
+        }
+        if (anyDigit && p < end && (*p == 'e' || *p == 'E'))
+        {
+            p++;
+            const bool negativeExponent = p < end && *p == '-';
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                p++;
+            }
+            int decimalExponent = 0;
+            bool anyExponentDigit = false;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                decimalExponent = std::min(decimalExponent * 10 + (*p - '0'), 100000);
+                anyExponentDigit = true;
+                p++;
+            }
+            anyDigit = anyExponentDigit;
+            exponent += negativeExponent ? -decimalExponent : decimalExponent;
+        }
+
+        const bool atDelimiter = p == end || *p == ',' || *p == '\n' || *p == '\r' || *p == ' ' || *p == '\t';
+        if (anyDigit && atDelimiter && !truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+        {
+            const double magnitude = exponent < 0 ? static_cast<double>(mantissa) / POWERS_OF_TEN[-exponent]
+                                                  : static_cast<double>(mantissa) * POWERS_OF_TEN[exponent];
+            value = negative ? -magnitude : magnitude;
+            cursor = p;
+            return true;
+        }
+
+        // Slow path on a null-terminated copy of the token
+        const char *tokenEnd = token;
+        while (tokenEnd < end && *tokenEnd != ',' && *tokenEnd != '\n' && *tokenEnd != '\r' && *tokenEnd != ' ' && *tokenEnd != '\t')
+        {
+            tokenEnd++;
+        }
+        char buffer[64];
+        const std::size_t length = static_cast<std::size_t>(tokenEnd - token);
+        if (length == 0 || length >= sizeof(buffer))
+        {
+            return false;
+        }
+        std::memcpy(buffer, token, length);
+        buffer[length] = '\0';
+        char *parsedEnd = nullptr;
+        value = std::strtod(buffer, &parsedEnd);
+        if (parsedEnd != buffer + length)
+        {
+            return false;
+        }
+        cursor = tokenEnd;
+        return true;
+    }
+
+    /**
+     * \brief Parses a row of PD comma-separated numbers into a point of a set.
+     *
+     * \param line The first character of the row.
+     * \param last The end of the row, excluding the newline.
+     * \param points The point set receiving the coordinates.
+     * \param index The index of the point in the set.
+     * \return False if the row does not hold exactly PD numbers.
+     */
+    template <typename PT, std::size_t PD>
+    static bool parseRow(const char *line, const char *last, PointSet<PT, PD> &points, std::size_t index)
+    {
+        const char *cursor = line;
+        for (std::size_t d = 0; d < PD; ++d)
+        {
+            double value;
+            if (!parseNumber(cursor, last, value))
+            {
+                return false;
+            }
+            points(index, d) = static_cast<PT>(value);
+
+            cursor = skipSpaces(cursor, last);
+            if (d + 1 < PD)
+            {
+                if (cursor == last || *cursor != ',')
+                {
+                    return false;
+                }
+                cursor++;
+            }
+        }
+        return cursor == last;
+    }
+
+    /**
+     * \brief Skips the byte order mark and the header row of a CSV file, if any.
+     *
+     * The first non-blank row is a header if it is not made of numbers only.
+     *
+     * \param begin The first character of the file.
+     * \param end The end of the file.
+     * \return The first character of the data.
+     */
+    static const char *skipHeader(const char *begin, const char *end)
+    {
+        if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+        {
+            begin += 3;
+        }
+
+        const char *line = begin, *next = begin;
+        const char *last = line;
+        while (line < end && isBlank(line, last = lineEnd(line, end, next)))
+        {
+            line = next;
+        }
+        if (line == end)
+        {
+            return end;
+        }
+
+        const char *cursor = line;
+        while (true)
+        {
+            double value;
+            if (!parseNumber(cursor, last, value))
+            {
+                return next;
+            }
+            cursor = skipSpaces(cursor, last);
+            if (cursor == last)
+            {
+                return line;
+            }
+            if (*cursor != ',')
+            {
+                return next;
+            }
+            cursor++;
+        }
+    }
+
+    /**
+     * \brief Returns the end of the line starting at a position, excluding the newline and carriage return.
+     *
+     * \param line The first character of the line.
+     * \param end The end of the text.
+     * \param next Set to the start of the following line, or to the end of the text.
+     */
+    static const char *lineEnd(const char *line, const char *end, const char *&next)
+    {
+        const void *newline = std::memchr(line, '\n', static_cast<std::size_t>(end - line));
+        const char *last = newline ? static_cast<const char *>(newline) : end;
+        next = newline ? last + 1 : end;
+        return last > line && last[-1] == '\r' ? last - 1 : last;
+    }
+
+    /**
+     * \brief Returns the start of the line following a position, or the end of the text.
+     */
+    static const char *nextLine(const char *cursor, const char *end)
+    {
+        const void *newline = std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor));
+        return newline ? static_cast<const char *>(newline) + 1 : end;
+    }
+
+    /**
+     * \brief Tells whether a line only holds spaces.
+     */
+    static bool isBlank(const char *line, const char *last)
+    {
+        return skipSpaces(line, last) == last;
+    }
+
+private:
+    static const char *skipSpaces(const char *cursor, const char *last)
+    {
+        while (cursor < last && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+        {
+            cursor++;
+        }
+        return cursor;
+    }
+};
+
+/**
+ * \class CSVBatchSource
+ * \brief Streams the rows of a numeric CSV file in batches, for the out-of-core modes.
+ *
+ * The file is memory-mapped and read from the first to the last row, so only the
+ * pages of the current batch need to be in memory. The rows of a batch are located
+ * sequentially and parsed in parallel. A file sorted by cluster gives biased batches
+ * and should be shuffled beforehand.
+ *
+ * \tparam PT The data type of the point coordinates (e.g., `float`, `double`).
+ * \tparam PD The number of dimensions of each point.
+ */
+template <typename PT, std::size_t PD>
+class CSVBatchSource : public BatchSource<PT, PD>
+{
+public:
+    /**
+     * \brief Opens a CSV file, skipping its header row if any.
+     *
+     * \param filepath The path to the CSV file.
+     * \throws std::runtime_error If the file cannot be opened.
+     */
+    explicit CSVBatchSource(const std::string &filepath) : file(filepath)
+    {
+        file.adviseSequential();
+        end = file.data() + file.size();
+        begin = CSVUtils::skipHeader(file.data(), end);
+        cursor = begin;
+    }
+
+    /**
+     * \brief Reads the next rows of the file.
+     *
+     * \throws std::runtime_error If a row is not made of PD numbers.
+     */
+    std::size_t nextBatch(std::size_t batchSize, PointSet<PT, PD> &batch) override
+    {
+        lines.clear();
+        while (lines.size() < batchSize && cursor < end)
+        {
+            const char *next;
+            const char *last = CSVUtils::lineEnd(cursor, end, next);
+            if (!CSVUtils::isBlank(cursor, last))
+            {
+                lines.emplace_back(cursor, last);
+            }
+            cursor = next;
+        }
+
+        const std::size_t numRows = lines.size();
+        batch.resize(numRows);
+        std::size_t firstInvalidRow = numRows;
+        #pragma omp parallel for schedule(static) reduction(min : firstInvalidRow)
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            if (!CSVUtils::parseRow(lines[i].first, lines[i].second, batch, i))
+            {
+                firstInvalidRow = std::min(firstInvalidRow, i);
+            }
+        }
+        if (firstInvalidRow < numRows)
+        {
+            throw std::runtime_error("Error reading CSV: row " + std::to_string(rowsRead + firstInvalidRow + 1) + " is not made of " + std::to_string(PD) + " numeric columns");
+        }
+
+        rowsRead += numRows;
+        return numRows;
+    }
+
+    void rewind() override
+    {
+        cursor = begin;
+        rowsRead = 0;
+    }
+
+private:
+    MappedFile file;                                     ///< Mapped content of the file.
+    const char *begin = nullptr;                         ///< First character of the data, after the header.
+    const char *end = nullptr;                           ///< End of the file.
+    const char *cursor = nullptr;                        ///< First character of the next row to read.
+    std::size_t rowsRead = 0;                            ///< Number of rows read since the last rewind.
+    std::vector<std::pair<const char *, const char *>> lines; ///< Rows of the current batch.
 };
 
 #endif // CSVUTILS_HPP
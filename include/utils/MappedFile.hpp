@@ -0,0 +1,171 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#undef max
+#undef min
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * \class MappedFile
+ * \brief Read-only memory mapping of a whole file.
+ *
+ * The pages are loaded by the operating system on first access and can be dropped
+ * under memory pressure, so a file larger than the memory can be scanned without
+ * being read into a buffer. The mapping uses `mmap` on POSIX systems and a file
+ * mapping object on Windows, and is released by the destructor.
+ */
+class MappedFile
+{
+public:
+    /**
+     * \brief Maps a file in memory.
+     *
+     * \param path The path of the file.
+     * \throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize))
+        {
+            release();
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        length = static_cast<std::size_t>(fileSize.QuadPart);
+        if (length == 0)
+        {
+            return;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        bytes = mapping ? static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+        descriptor = ::open(path.c_str(), O_RDONLY);
+        struct stat status;
+        if (descriptor < 0 || ::fstat(descriptor, &status) != 0)
+        {
+            release();
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        length = static_cast<std::size_t>(status.st_size);
+        if (length == 0)
+        {
+            return;
+        }
+        void *address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        bytes = address == MAP_FAILED ? nullptr : static_cast<const char *>(address);
+#endif
+        if (bytes == nullptr)
+        {
+            release();
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept { swap(other); }
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        MappedFile moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    ~MappedFile() { release(); }
+
+    /**
+     * \brief Returns the first byte of the file, nullptr if the file is empty.
+     */
+    const char *data() const { return bytes; }
+
+    /**
+     * \brief Returns the size of the file, in bytes.
+     */
+    std::size_t size() const { return length; }
+
+    /**
+     * \brief Tells the operating system that the file is read sequentially, so it reads ahead.
+     */
+    void adviseSequential() const
+    {
+#ifndef _WIN32
+        if (bytes != nullptr)
+        {
+            ::madvise(const_cast<char *>(bytes), length, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+private:
+    const char *bytes = nullptr; ///< Mapped content of the file.
+    std::size_t length = 0;      ///< Size of the file, in bytes.
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE; ///< Handle of the open file.
+    HANDLE mapping = nullptr;           ///< Handle of the file mapping object.
+#else
+    int descriptor = -1; ///< Descriptor of the open file.
+#endif
+
+    void swap(MappedFile &other) noexcept
+    {
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#else
+        std::swap(descriptor, other.descriptor);
+#endif
+    }
+
+    void release() noexcept
+    {
+#ifdef _WIN32
+        if (bytes != nullptr)
+        {
+            UnmapViewOfFile(bytes);
+        }
+        if (mapping != nullptr)
+        {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+        }
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes != nullptr)
+        {
+            ::munmap(const_cast<char *>(bytes), length);
+        }
+        if (descriptor >= 0)
+        {
+            ::close(descriptor);
+        }
+        descriptor = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,144 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * \class RadixHeap
+ * \brief A monotone priority queue for non-negative floating point keys.
+ *
+ * Dijkstra's algorithm never pushes a key smaller than the last one popped, so the
+ * keys can be kept in 65 buckets indexed by the highest bit in which they differ from
+ * the last popped key. A push is O(1) and every element is moved to a lower bucket at
+ * most 64 times, without the comparisons and cache misses of a binary heap.
+ *
+ * The keys are compared through their IEEE-754 bit patterns, which are ordered like
+ * the values for non-negative doubles. Pushing a negative key, or a key smaller than
+ * the last popped one, is undefined.
+ *
+ * \tparam T The type of the values stored with the keys (e.g., a face index).
+ */
+template <typename T>
+class RadixHeap
+{
+public:
+    /**
+     * \brief Inserts a value with its key.
+     *
+     * \param key The key, not smaller than the last popped one.
+     * \param value The value stored with the key.
+     */
+    void push(double key, const T &value)
+    {
+        const uint64_t bits = toBits(key);
+        buckets[bucketIndex(bits)].push_back({bits, value});
+        count++;
+    }
+
+    /**
+     * \brief Removes the element with the smallest key.
+     *
+     * \return The key and the value of the removed element.
+     */
+    std::pair<double, T> pop()
+    {
+        if (buckets[0].empty())
+        {
+            refill();
+        }
+        auto [bits, value] = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return {fromBits(bits), value};
+    }
+
+    /**
+     * \brief Removes all the elements, keeping the memory of the buckets.
+     */
+    void clear()
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        last = 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+
+private:
+    std::array<std::vector<std::pair<uint64_t, T>>, 65> buckets; ///< Elements grouped by the highest bit differing from `last`.
+    uint64_t last = 0;                                           ///< Bit pattern of the last popped key.
+    std::size_t count = 0;                                       ///< Number of elements in the heap.
+
+    static uint64_t toBits(double key)
+    {
+        key += 0.0; // turns -0.0 into +0.0
+        uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    static double fromBits(uint64_t bits)
+    {
+        double key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return key;
+    }
+
+    std::size_t bucketIndex(uint64_t bits) const
+    {
+        const uint64_t diff = bits ^ last;
+        if (diff == 0)
+        {
+            return 0;
+        }
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, diff);
+        return index + 1;
+#else
+        return 64 - __builtin_clzll(diff);
+#endif
+    }
+
+    /**
+     * \brief Moves the elements of the first non-empty bucket to lower buckets.
+     *
+     * The smallest key of that bucket becomes `last`, so at least one element lands in bucket 0.
+     */
+    void refill()
+    {
+        std::size_t i = 1;
+        while (buckets[i].empty())
+        {
+            i++;
+        }
+
+        uint64_t minBits = buckets[i][0].first;
+        for (const auto &element : buckets[i])
+        {
+            minBits = element.first < minBits ? element.first : minBits;
+        }
+        last = minBits;
+
+        for (const auto &element : buckets[i])
+        {
+            buckets[bucketIndex(element.first)].push_back(element);
+        }
+        buckets[i].clear();
+    }
+};
+
+#endif // RADIX_HEAP_HPP
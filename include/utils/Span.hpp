@@ -0,0 +1,62 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * \class Span
+ * \brief A non-owning view over a contiguous range of elements.
+ *
+ * Minimal replacement for C++20 `std::span`: it stores a pointer and a size, so it
+ * can be returned by value from accessors of flat arrays without copying them.
+ * The view is valid as long as the underlying storage is neither destroyed nor resized.
+ *
+ * \tparam T The type of the elements (use a const type for read-only views).
+ */
+template <typename T>
+class Span
+{
+public:
+    /**
+     * \brief Creates an empty view.
+     */
+    Span() = default;
+
+    /**
+     * \brief Creates a view over `size` elements starting at `data`.
+     *
+     * \param data Pointer to the first element.
+     * \param size Number of elements in the view.
+     */
+    Span(T *data, std::size_t size) : ptr(data), length(size) {}
+
+    /**
+     * \brief Creates a view over the whole content of a vector.
+     *
+     * \param vector The vector to view.
+     */
+    template <typename U>
+    Span(std::vector<U> &vector) : ptr(vector.data()), length(vector.size()) {}
+
+    /**
+     * \brief Creates a view over the whole content of a vector.
+     *
+     * \param vector The vector to view.
+     */
+    template <typename U>
+    Span(const std::vector<U> &vector) : ptr(vector.data()), length(vector.size()) {}
+
+    T *begin() const { return ptr; }
+    T *end() const { return ptr + length; }
+    T *data() const { return ptr; }
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    T &operator[](std::size_t i) const { return ptr[i]; }
+
+private:
+    T *ptr = nullptr;       ///< First element of the view.
+    std::size_t length = 0; ///< Number of elements in the view.
+};
+
+#endif // SPAN_HPP
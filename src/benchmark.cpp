@@ -1,11 +1,15 @@
 #include <vector>
+#include <queue>
+#include <unordered_map>
 #include <benchmark/benchmark.h>
 #include <iostream>
+#include <random>
 #include <omp.h>
 
 #include "mesh_segmentation/MeshSegmentation.hpp"
 #include "geometry/metrics/EuclideanMetric.hpp"
 #include "geometry/metrics/GeodesicDijkstraMetric.hpp"
+#include "geometry/kdtree/KDTree.hpp"
 
 using namespace std;
 
@@ -48,4 +52,107 @@ BENCHMARK(BM_MeshSegmentation)
     ->DenseRange(1, 7, 1)                    
     ->Complexity();
 
+// Exposes the single-source search of the Dijkstra metric to the benchmarks
+class DijkstraBenchmarkMetric : public GeodesicDijkstraMetric<double, 3> {
+public:
+    using GeodesicDijkstraMetric<double, 3>::GeodesicDijkstraMetric;
+    using GeodesicDijkstraMetric<double, 3>::setupAdjacency;
+    using GeodesicDijkstraMetric<double, 3>::computeDistances;
+};
+
+// Previous search: hash map of visited faces and binary heap with lazy deletion
+static std::vector<double> legacyComputeDistances(const Mesh& mesh, FaceId startFace) {
+    std::vector<double> distances(mesh.numFaces());
+    std::unordered_map<FaceId, bool> visited;
+    std::priority_queue<std::pair<double, FaceId>, std::vector<std::pair<double, FaceId>>, std::greater<>> pq;
+
+    for (int i = 0; i < mesh.numFaces(); ++i) {
+        distances[i] = std::numeric_limits<double>::max();
+        visited[i] = false;
+    }
+
+    distances[startFace] = 0;
+    pq.push({0, startFace});
+
+    while (!pq.empty()) {
+        auto [currentDistance, currentFace] = pq.top();
+        pq.pop();
+
+        if (visited[currentFace])
+            continue;
+        visited[currentFace] = true;
+
+        Span<const FaceId> neighbors = mesh.getFaceAdjacencyAt(currentFace);
+        Span<const double> weights = mesh.getFaceAdjacencyWeightsAt(currentFace);
+        for (std::size_t i = 0; i < neighbors.size(); ++i) {
+            if (distances[currentFace] + weights[i] < distances[neighbors[i]]) {
+                distances[neighbors[i]] = distances[currentFace] + weights[i];
+                pq.push({distances[neighbors[i]], neighbors[i]});
+            }
+        }
+    }
+
+    return distances;
+}
+
+static void BM_DijkstraLegacy(benchmark::State& state) {
+    Mesh mesh(mesh_files[state.range(0)]);
+    DijkstraBenchmarkMetric metric(mesh, 0.05, mesh.getMeshFacesPoints());
+    metric.setupAdjacency();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyComputeDistances(mesh, 0));
+    }
+
+    state.SetComplexityN(mesh.numFaces());
+}
+
+static void BM_DijkstraRadixHeap(benchmark::State& state) {
+    Mesh mesh(mesh_files[state.range(0)]);
+    DijkstraBenchmarkMetric metric(mesh, 0.05, mesh.getMeshFacesPoints());
+    metric.setupAdjacency();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(metric.computeDistances(0));
+    }
+
+    state.SetComplexityN(mesh.numFaces());
+}
+
+BENCHMARK(BM_DijkstraLegacy)
+    ->DenseRange(0, 6, 1)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+
+BENCHMARK(BM_DijkstraRadixHeap)
+    ->DenseRange(0, 6, 1)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+
+// Builds a kd-tree over uniformly distributed points
+static void BM_KdTreeBuild(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    PointSet<double, 3> points(n);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    for (std::size_t d = 0; d < 3; ++d) {
+        for (std::size_t i = 0; i < n; ++i) {
+            points.data(d)[i] = distribution(generator);
+        }
+    }
+
+    for (auto _ : state) {
+        KdTree<double, 3> tree(points);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+
+    state.SetComplexityN(n);
+}
+
+BENCHMARK(BM_KdTreeBuild)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oNLogN);
+
 BENCHMARK_MAIN();
@@ -34,7 +34,7 @@ void MostDistanceClass<PD>::findCentroid(std::vector<CentroidPoint<double, PD>>&
                 double minDistance = std::numeric_limits<double>::infinity();
 
                 for (const auto& centroid : centroids) {
-                    double distance = EuclideanMetric<double, PD>::distanceTo(point, centroid);
+                    double distance = EuclideanMetric<double, PD>::squaredDistance(point, centroid);
                     if (distance < minDistance) {
                         minDistance = distance;
                     }
@@ -14,6 +14,18 @@ std::vector<Point<PT, PD>> &KMeans<PT, PD, M>::getPoints()
   return metric->getPoints();
 }
 
+template <typename PT, std::size_t PD, class M>
+PointSet<PT, PD> &KMeans<PT, PD, M>::getPointSet()
+{
+  return metric->getPointSet();
+}
+
+template <typename PT, std::size_t PD, class M>
+const std::vector<int32_t> &KMeans<PT, PD, M>::getAssignments() const
+{
+  return metric->getAssignments();
+}
+
 template <typename PT, std::size_t PD, class M>
 std::vector<CentroidPoint<PT, PD>> &KMeans<PT, PD, M>::getCentroids()
 {
@@ -123,29 +135,21 @@ void KMeans<PT, PD, M>::print()
   std::vector<std::vector<double>> x_points_per_centroid(centroids.size());
   std::vector<std::vector<double>> y_points_per_centroid(centroids.size());
 
-  for (auto &p : points)
+  const std::vector<int32_t> &assignments = metric->getAssignments();
+
+  for (std::size_t i = 0; i < points.size(); ++i)
   {
+    const auto &p = points[i];
     p.print();
-    if (p.centroid != nullptr) // Check if a centroid is set
+    const int32_t centroid_index = i < assignments.size() ? assignments[i] : PointSet<PT, PD>::UNASSIGNED;
+    if (centroid_index != PointSet<PT, PD>::UNASSIGNED) // Check if a centroid is set
     {
       std::cout << " -> Centroid: ";
-      p.centroid->print();
-
-      auto centroid_candidate = CentroidPoint<PT, PD>(*p.centroid); // Convert Point to CentroidPoint
-      auto it = std::find(centroids.begin(), centroids.end(), centroid_candidate);
-
-      if (it != centroids.end())
-      {
-        int centroid_index = std::distance(centroids.begin(), it);
-
-        // Add the point's coordinates to the appropriate centroid's point vector
-        x_points_per_centroid[centroid_index].push_back(p.coordinates[0]);
-        y_points_per_centroid[centroid_index].push_back(p.coordinates[1]);
-      }
-      else
-      {
-        std::cerr << "Error: Centroid not found!" << std::endl;
-      }
+      centroids[centroid_index].print();
+
+      // Add the point's coordinates to the appropriate centroid's point vector
+      x_points_per_centroid[centroid_index].push_back(p.coordinates[0]);
+      y_points_per_centroid[centroid_index].push_back(p.coordinates[1]);
     }
     else
     {
@@ -157,5 +161,8 @@ void KMeans<PT, PD, M>::print()
 
 template class KMeans<double, 2, EuclideanMetric<double, 2>>;
 template class KMeans<double, 3, EuclideanMetric<double, 3>>;
+template class KMeans<double, 2, MiniBatchEuclideanMetric<double, 2>>;
+template class KMeans<double, 3, MiniBatchEuclideanMetric<double, 3>>;
 template class KMeans<double, 3, GeodesicHeatMetric<double, 3>>;
 template class KMeans<double, 3, GeodesicDijkstraMetric<double, 3>>;
+template class KMeans<double, 3, GeodesicVoronoiMetric<double, 3>>;
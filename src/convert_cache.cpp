@@ -0,0 +1,93 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <filesystem>
+
+#include "geometry/mesh/Mesh.hpp"
+#include "geometry/mesh/MeshCache.hpp"
+#include "geometry/point/PointSetCache.hpp"
+#include "utils/CSVUtils.hpp"
+
+using namespace std;
+
+void printUsage(const char *name)
+{
+    std::cerr << "Usage: " << name << " <file>... [--dim <dimension>]" << std::endl;
+    std::cerr << "  <file>            : .obj mesh or .csv point cloud, converted to <file>.kmesh or <file>.kpts" << std::endl;
+    std::cerr << "  --dim <dimension> : Number of columns of the .csv files (2 or 3, default 2)" << std::endl;
+}
+
+template <std::size_t PD>
+bool convertPointCloud(const std::filesystem::path &path, const BinaryCache::SourceStamp &stamp)
+{
+    PointSet<double, PD> points = CSVUtils::readPointSet<double, PD>(path.string());
+    return PointSetCache::save(points, BinaryCache::cachePath(path, PointSetCache::EXTENSION), stamp);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::filesystem::path> files;
+    int dimension = 2;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--dim" && i + 1 < argc)
+        {
+            dimension = std::stoi(argv[++i]);
+        }
+        else
+        {
+            files.emplace_back(argument);
+        }
+    }
+    if (files.empty() || (dimension != 2 && dimension != 3))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (const auto &path : files)
+    {
+        try
+        {
+            BinaryCache::SourceStamp stamp;
+            if (!BinaryCache::stamp(path, stamp))
+            {
+                throw std::runtime_error("Cannot open file");
+            }
+
+            bool written = false;
+            std::filesystem::path output;
+            if (path.extension() == ".obj")
+            {
+                // Parses the .obj file without going through an existing cache
+                MeshCache::setEnabled(false);
+                Mesh mesh(path.string());
+                output = BinaryCache::cachePath(path, MeshCache::EXTENSION);
+                written = MeshCache::save(mesh, output, stamp);
+            }
+            else if (path.extension() == ".csv")
+            {
+                output = BinaryCache::cachePath(path, PointSetCache::EXTENSION);
+                written = dimension == 2 ? convertPointCloud<2>(path, stamp) : convertPointCloud<3>(path, stamp);
+            }
+            else
+            {
+                throw std::runtime_error("Unsupported extension, expected .obj or .csv");
+            }
+
+            if (!written)
+            {
+                throw std::runtime_error("Cannot write " + output.string());
+            }
+            std::cout << path.string() << " -> " << output.string() << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << path.string() << ": " << e.what() << std::endl;
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -18,7 +18,7 @@ int main(int argc, char* argv[])
     if (argc < 3) {
         std::cout << "Usage: " << argv[0] << " <num_initialization_method> <metric>" << endl;
         std::cout << "  <num_initialization_method> : Initialization method for centroids (0: random, 1: KDE, 2: most distant, 3: Static KDE - 3D point)" << endl;
-        std::cout << "  <metric>                     : Distance metric (0: Euclidean, 1: Dijkstra, 2: Heat)" << endl;
+        std::cout << "  <metric>                     : Distance metric (0: Euclidean, 1: Dijkstra, 2: Heat, 3: Voronoi)" << endl;
         return 1;
     }
     
@@ -59,6 +59,10 @@ int main(int argc, char* argv[])
                             MeshSegmentation<GeodesicHeatMetric<double, 3>> segmentation(&mesh, num_clusters, 0.1, num_initialization_method, 0);
                             segmentation.fit();
                         }
+                        else if(metric == 3) {
+                            MeshSegmentation<GeodesicVoronoiMetric<double, 3>> segmentation(&mesh, num_clusters, 0.05, num_initialization_method, 0);
+                            segmentation.fit();
+                        }
 
                         Segmentation s1(&mesh, num_clusters);
                         Segmentation s2(&mesh2, num_clusters);
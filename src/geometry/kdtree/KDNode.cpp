@@ -3,20 +3,20 @@
 // Default constructor
 template <typename PT, std::size_t PD>
 KdNode<PT, PD>::KdNode()
-    : HasWgtCent<PT, PD>(), cellMin(), cellMax()
+    : cellMin(), cellMax(), wgtCent()
 {
     cellMin.fill(0); // Initialize the cellMin array to zero
     cellMax.fill(0); // Initialize the cellMax array to zero
+    wgtCent.fill(0); // Initialize the weighted centroid to zero
 }
 
 // Constructor with bounding box
 template <typename PT, std::size_t PD>
 KdNode<PT, PD>::KdNode(const std::array<PT, PD> &min, const std::array<PT, PD> &max)
-    : HasWgtCent<PT, PD>(), cellMin(min), cellMax(max) {}
-
-// Virtual destructor (defaulted)
-template <typename PT, std::size_t PD>
-KdNode<PT, PD>::~KdNode() = default;
+    : cellMin(min), cellMax(max), wgtCent()
+{
+    wgtCent.fill(0);
+}
 
 // Explicit instantiations
 template class KdNode<double, 2>; // 2D nodes with double coordinates
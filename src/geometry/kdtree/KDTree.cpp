@@ -1,89 +1,296 @@
 #include "geometry/kdtree/KDTree.hpp"
+#include <numeric>
 
 // Constructor: initializes the KD-tree by building it
 template <typename PT, std::size_t PD>
-KdTree<PT, PD>::KdTree(std::vector<Point<PT, PD>> &points)
+KdTree<PT, PD>::KdTree(std::vector<Point<PT, PD>> &points, std::size_t bucketSize)
+    : KdTree(PointSet<PT, PD>(points), bucketSize)
 {
-    root = buildTree(points.begin(), points.end(), 0);
 }
 
-// Recursively builds the KD-tree
+// Constructor: initializes the KD-tree over the indices of a point set
 template <typename PT, std::size_t PD>
-std::unique_ptr<KdNode<PT, PD>> KdTree<PT, PD>::buildTree(typename std::vector<Point<PT, PD>>::iterator begin,
-                                                          typename std::vector<Point<PT, PD>>::iterator end,
-                                                          int depth)
+KdTree<PT, PD>::KdTree(const PointSet<PT, PD> &points, std::size_t bucketSize)
+    : bucketSize(std::max<std::size_t>(bucketSize, 1))
 {
-    if (begin == end)
-        return nullptr; // Base case: no points
+    if (points.empty())
+        return;
 
-    // Allocate a new KD-tree node safely
-    auto node = std::make_unique<KdNode<PT, PD>>();
-    size_t count = std::distance(begin, end);
-    node->count = count;
-    node->wgtCent = Point<PT, PD>::vectorSum(begin, end).coordinates;
+    indices.resize(points.size());
+    std::iota(indices.begin(), indices.end(), 0);
 
-    // Initialize cell bounds
-    for (std::size_t i = 0; i < PD; ++i)
+    // The whole buffer is allocated once, every node is then written in place
+    nodes.resize(countNodes(points.size()));
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coordinates[d].resize(points.size());
+    }
+    if (points.size() >= PARALLEL_SELECT_MIN_POINTS)
+    {
+        scratch.resize(points.size());
+    }
+
+    // One team builds the whole tree, the subtrees and partitions are spread as tasks
+    #pragma omp parallel
+    #pragma omp single
+    buildTree(points, 0, 0, static_cast<int32_t>(points.size()), 0);
+
+    subtreeSizes.clear();
+    std::vector<int32_t>().swap(scratch);
+}
+
+// Number of nodes of a subtree, memoized since a level has at most two distinct sizes
+template <typename PT, std::size_t PD>
+std::size_t KdTree<PT, PD>::countNodes(std::size_t count)
+{
+    if (count <= bucketSize)
+        return 1;
+
+    auto it = subtreeSizes.find(count);
+    if (it != subtreeSizes.end())
+        return it->second;
+
+    std::size_t size = 1 + countNodes(count / 2) + countNodes(count - count / 2);
+    subtreeSizes[count] = size;
+    return size;
+}
+
+// Recursively builds the KD-tree
+template <typename PT, std::size_t PD>
+void KdTree<PT, PD>::buildTree(const PointSet<PT, PD> &points, int32_t nodeIndex, int32_t begin, int32_t end, int depth)
+{
+    KdNode<PT, PD> &node = nodes[nodeIndex];
+    const std::size_t count = end - begin;
+    node.count = static_cast<int>(count);
+    node.begin = begin;
+    node.end = end;
+
+    // A leaf scans its points once: bounds, sum and coordinates in tree order
+    if (count <= bucketSize)
     {
-        node->cellMin[i] = std::numeric_limits<PT>::max();
-        node->cellMax[i] = std::numeric_limits<PT>::lowest();
-        for (auto it = begin; it != end; ++it)
+        for (std::size_t i = 0; i < PD; ++i)
         {
-            node->cellMin[i] = std::min(node->cellMin[i], it->getValues()[i]);
-            node->cellMax[i] = std::max(node->cellMax[i], it->getValues()[i]);
+            const PT *values = points.data(i);
+            PT *ordered = coordinates[i].data();
+            PT sum = 0;
+            node.cellMin[i] = std::numeric_limits<PT>::max();
+            node.cellMax[i] = std::numeric_limits<PT>::lowest();
+            for (int32_t j = begin; j < end; ++j)
+            {
+                const PT value = values[indices[j]];
+                ordered[j] = value;
+                sum += value;
+                node.cellMin[i] = std::min(node.cellMin[i], value);
+                node.cellMax[i] = std::max(node.cellMax[i], value);
+            }
+            node.wgtCent[i] = sum;
         }
+        return;
     }
 
-    // If there is only one point, store it in the node
-    if (count == 1)
+    // Choose splitting axis and find the median
+    const int axis = depth % PD;
+    const int32_t median = begin + static_cast<int32_t>(count / 2);
+    selectMedian(points.data(axis), begin, median, end);
+
+    // Children are laid out in pre-order: the left subtree follows its parent
+    const int32_t leftIndex = nodeIndex + 1;
+    const std::size_t leftCount = count / 2;
+    const int32_t rightIndex = leftIndex + static_cast<int32_t>(leftCount <= bucketSize ? 1 : subtreeSizes.at(leftCount));
+    node.left = leftIndex;
+    node.right = rightIndex;
+
+    // The two subtrees cover disjoint ranges of the permutation and of the node buffer
+    #pragma omp task if (count >= TASK_MIN_POINTS) default(shared) firstprivate(leftIndex, begin, median, depth)
+    buildTree(points, leftIndex, begin, median, depth + 1);
+    buildTree(points, rightIndex, median, end, depth + 1);
+    #pragma omp taskwait
+
+    // Bounds and sums are combined bottom-up from the children
+    const KdNode<PT, PD> &left = nodes[leftIndex];
+    const KdNode<PT, PD> &right = nodes[rightIndex];
+    for (std::size_t i = 0; i < PD; ++i)
     {
-        node->myPoint = std::make_unique<Point<PT, PD>>(*begin);
-        return node;
+        node.cellMin[i] = std::min(left.cellMin[i], right.cellMin[i]);
+        node.cellMax[i] = std::max(left.cellMax[i], right.cellMax[i]);
+        node.wgtCent[i] = left.wgtCent[i] + right.wgtCent[i];
     }
+}
+
+// Selects the median of a range, narrowing large ranges with parallel three-way partitions
+template <typename PT, std::size_t PD>
+void KdTree<PT, PD>::selectMedian(const PT *axisValues, int32_t begin, int32_t median, int32_t end)
+{
+    constexpr int32_t SAMPLE_SIZE = 31;
+    constexpr int32_t CHUNK_SIZE = 1 << 14;
+
+    while (static_cast<std::size_t>(end - begin) >= PARALLEL_SELECT_MIN_POINTS)
+    {
+        // The pivot is the median of points evenly spread over the range
+        const int64_t count = end - begin;
+        std::array<PT, SAMPLE_SIZE> sample;
+        for (int32_t s = 0; s < SAMPLE_SIZE; ++s)
+        {
+            sample[s] = axisValues[indices[begin + count * (2 * s + 1) / (2 * SAMPLE_SIZE)]];
+        }
+        std::nth_element(sample.begin(), sample.begin() + SAMPLE_SIZE / 2, sample.end());
+        const PT pivot = sample[SAMPLE_SIZE / 2];
+
+        // Every chunk counts its points below, equal to and above the pivot
+        const int32_t numChunks = static_cast<int32_t>((count + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        std::vector<std::array<int32_t, 3>> offsets(numChunks + 1, {0, 0, 0});
+        #pragma omp taskloop grainsize(1) default(shared)
+        for (int32_t c = 0; c < numChunks; ++c)
+        {
+            const int32_t first = begin + c * CHUNK_SIZE;
+            const int32_t last = std::min(end, first + CHUNK_SIZE);
+            std::array<int32_t, 3> counts = {0, 0, 0};
+            for (int32_t j = first; j < last; ++j)
+            {
+                const PT value = axisValues[indices[j]];
+                counts[(value < pivot) ? 0 : (pivot < value) ? 2 : 1]++;
+            }
+            offsets[c + 1] = counts;
+        }
 
-    // Choose splitting axis
-    int axis = depth % PD;
+        // The prefix sums give the position of every chunk in the three parts
+        for (int32_t c = 0; c < numChunks; ++c)
+        {
+            for (int part = 0; part < 3; ++part)
+            {
+                offsets[c + 1][part] += offsets[c][part];
+            }
+        }
+        const int32_t lessEnd = begin + offsets[numChunks][0];
+        const int32_t equalEnd = lessEnd + offsets[numChunks][1];
 
-    // Efficiently find the median
-    auto median = begin + count / 2;
-    std::nth_element(begin, median, end, [axis](const Point<PT, PD> &a, const Point<PT, PD> &b)
-                     { return a.getValues()[axis] < b.getValues()[axis]; });
+        // Every chunk scatters its points to the scratch buffer, which is then copied back
+        #pragma omp taskloop grainsize(1) default(shared)
+        for (int32_t c = 0; c < numChunks; ++c)
+        {
+            const int32_t first = begin + c * CHUNK_SIZE;
+            const int32_t last = std::min(end, first + CHUNK_SIZE);
+            std::array<int32_t, 3> next = {begin + offsets[c][0], lessEnd + offsets[c][1], equalEnd + offsets[c][2]};
+            for (int32_t j = first; j < last; ++j)
+            {
+                const PT value = axisValues[indices[j]];
+                scratch[next[(value < pivot) ? 0 : (pivot < value) ? 2 : 1]++] = indices[j];
+            }
+        }
+        #pragma omp taskloop grainsize(1) default(shared)
+        for (int32_t c = 0; c < numChunks; ++c)
+        {
+            const int32_t first = begin + c * CHUNK_SIZE;
+            const int32_t last = std::min(end, first + CHUNK_SIZE);
+            std::copy(scratch.begin() + first, scratch.begin() + last, indices.begin() + first);
+        }
+
+        // Only the part containing the median needs further selection
+        if (median < lessEnd)
+            end = lessEnd;
+        else if (median < equalEnd)
+            return;
+        else
+            begin = equalEnd;
+    }
+
+    std::nth_element(indices.begin() + begin, indices.begin() + median, indices.begin() + end,
+                     [axisValues](int32_t a, int32_t b)
+                     { return axisValues[a] < axisValues[b]; });
+}
 
-    // Determine if parallel execution is possible
-    int max_threads = omp_get_max_threads();
+// Nearest neighbour search with an explicit stack over the node buffer
+template <typename PT, std::size_t PD>
+int32_t KdTree<PT, PD>::nearest(const std::array<PT, PD> &query) const
+{
+    if (nodes.empty())
+        return -1;
 
-#pragma omp parallel sections if (depth < std::log2(max_threads))
+    // Squared distance from the query to the bounding box of a node
+    auto boxDistance = [&query](const KdNode<PT, PD> &node)
+    {
+        PT sum = 0;
+        for (std::size_t d = 0; d < PD; ++d)
         {
-#pragma omp section
-            node->left = buildTree(begin, median, depth + 1);
+            const PT gap = std::max({node.cellMin[d] - query[d], query[d] - node.cellMax[d], PT(0)});
+            sum += gap * gap;
+        }
+        return sum;
+    };
 
-#pragma omp section
-            node->right = buildTree(median, end, depth + 1);
+    PT bestDistance = std::numeric_limits<PT>::max();
+    int32_t best = -1;
+
+    // The tree has at most 32 levels, the farther child of each level waits on the stack
+    std::array<int32_t, 64> stack;
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const KdNode<PT, PD> &node = nodes[stack[--top]];
+        // Equal distances are still visited, a point with a lower index may be there
+        if (boxDistance(node) > bestDistance)
+            continue;
+
+        if (node.isLeaf())
+        {
+            for (int32_t j = node.begin; j < node.end; ++j)
+            {
+                PT distance = 0;
+                for (std::size_t d = 0; d < PD; ++d)
+                {
+                    const PT diff = coordinates[d][j] - query[d];
+                    distance += diff * diff;
+                }
+                if (distance < bestDistance || (distance == bestDistance && indices[j] < best))
+                {
+                    bestDistance = distance;
+                    best = indices[j];
+                }
+            }
+            continue;
         }
 
-    return node;
+        // The nearer child is pushed last, so it is visited first
+        const PT leftDistance = boxDistance(nodes[node.left]);
+        const PT rightDistance = boxDistance(nodes[node.right]);
+        if (leftDistance <= rightDistance)
+        {
+            stack[top++] = node.right;
+            stack[top++] = node.left;
+        }
+        else
+        {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+    return best;
 }
 
 template <typename PT, std::size_t PD>
-std::unique_ptr<KdNode<PT, PD>> &KdTree<PT, PD>::getRoot()
+const KdNode<PT, PD> *KdTree<PT, PD>::getRoot() const
 {
-    return root;
+    return nodes.empty() ? nullptr : nodes.data();
 }
 
 template <typename PT, std::size_t PD>
 KdTree<PT, PD>::~KdTree() {
-    clearTree(root);
+    clearTree();
 }
 
 template <typename PT, std::size_t PD>
-void KdTree<PT, PD>::clearTree(std::unique_ptr<KdNode<PT, PD>>& node) {
-    if (!node) return;
-    clearTree(node->left);
-    clearTree(node->right);
-    node.reset();  // Explicitly delete the node
+void KdTree<PT, PD>::clearTree() {
+    // Swap with empty buffers so that the memory is actually released
+    std::vector<KdNode<PT, PD>>().swap(nodes);
+    std::vector<int32_t>().swap(indices);
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        std::vector<PT>().swap(coordinates[d]);
+    }
 }
 
 
 // Explicit instantiation for supported types
 template class KdTree<double, 2>;
-template class KdTree<double, 3>;
\ No newline at end of file
+template class KdTree<double, 3>;
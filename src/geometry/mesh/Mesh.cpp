@@ -1,44 +1,43 @@
-#include "objload.h"
 #include "geometry/mesh/Mesh.hpp"
+#include "geometry/mesh/MeshCache.hpp"
+#include "geometry/mesh/ObjReader.hpp"
 #include <fstream> // For file output
 #include <sstream> // For stringstream
+#include <algorithm>
 
 Mesh::Mesh(const std::string path)
 {
-  try
+  if (std::filesystem::path(path).extension() == MeshCache::EXTENSION)
   {
-    std::ifstream in(path.c_str());
-    auto model = obj::parseObjModel(in);
-
-    meshVertices.reserve(model.vertex.size() / 3);
-    std::vector<Point<double, 3>> localMeshVertices(model.vertex.size() / 3);
-    #pragma omp parallel for
-    for (int i = 0; i < model.vertex.size(); i += 3)
+    if (!MeshCache::load(path, *this))
     {
-      std::array<double, 3> coords = {model.vertex[i], model.vertex[i + 1], model.vertex[i + 2]};
-      localMeshVertices[i / 3] = Point<double, 3>(coords, i / 3);
+      throw std::runtime_error("Failed to load file");
     }
-    meshVertices = std::move(localMeshVertices);
-
-    const auto faces = model.faces.at("default");
-    const auto &faceVertices = faces.first;
+    return;
+  }
 
-    meshFaces.reserve(faces.first.size() / 3);
-    std::vector<Face> localMeshFaces(faceVertices.size() / 3);
-    #pragma omp parallel for
-    for (int j = 0; j < faceVertices.size(); j = j + 3)
-    {
-      FaceId faceId(j / 3);
-      Face face = Face({VertId(faceVertices[j].v), VertId(faceVertices[j + 1].v), VertId(faceVertices[j + 2].v)}, meshVertices, faceId);
+  BinaryCache::SourceStamp stamp;
+  const bool cached = MeshCache::isEnabled() && BinaryCache::stamp(path, stamp);
+  const std::filesystem::path cachePath = BinaryCache::cachePath(path, MeshCache::EXTENSION);
+  if (cached && MeshCache::load(cachePath, *this, &stamp))
+  {
+    return;
+  }
 
-      localMeshFaces[j / 3] = face;
-    }
-    meshFaces = std::move(localMeshFaces);
+  try
+  {
+    ObjReader::read(path, *this);
   }
   catch (const std::exception &e)
   {
     throw std::runtime_error("Failed to load file");
   }
+
+  // Best effort: a read-only directory only costs the parsing on the next load
+  if (cached)
+  {
+    MeshCache::save(*this, cachePath, stamp);
+  }
 }
 
 std::ostream &operator<<(std::ostream &os, const Mesh &graph)
@@ -91,55 +90,113 @@ int Mesh::createSegmentationFromSegFile(const std::filesystem::path &path)
 
 void Mesh::buildFaceAdjacency()
 {
-    faceAdjacency.clear();
+    const size_t numFaces = meshFaces.size();
+    if (adjacencyOffsets.size() == numFaces + 1)
+    {
+        return; // Already built for the current faces
+    }
 
-    std::unordered_map<VertId, std::set<FaceId>> vertexToFaces;
+    // Vertex to face incidence as CSR arrays, sorted by vertex with a counting sort
+    const size_t numVertices = meshVertices.size();
+    std::vector<uint32_t> vertexOffsets(numVertices + 1, 0);
+    for (const auto &face : meshFaces)
+    {
+        for (VertId vertex : face.vertices)
+        {
+            vertexOffsets[vertex + 1]++;
+        }
+    }
+    for (size_t v = 0; v < numVertices; v++)
+    {
+        vertexOffsets[v + 1] += vertexOffsets[v];
+    }
 
-    #pragma omp parallel
+    std::vector<FaceId> vertexFaces(vertexOffsets[numVertices]);
+    std::vector<uint32_t> cursor(vertexOffsets.begin(), vertexOffsets.end() - 1);
+    for (size_t i = 0; i < numFaces; i++)
     {
-        std::unordered_map<VertId, std::set<FaceId>> vertexToFacesThreadLocal;
+        for (VertId vertex : meshFaces[i].vertices)
+        {
+            vertexFaces[cursor[vertex]++] = FaceId(i);
+        }
+    }
 
-        #pragma omp for nowait
-        for (size_t i = 0; i < meshFaces.size(); i++)
+    // Gathers the sorted, unique neighbors of a face in a scratch buffer
+    auto gatherNeighbors = [&](size_t i, std::vector<FaceId> &neighbors)
+    {
+        neighbors.clear();
+        for (VertId vertex : meshFaces[i].vertices)
         {
-            const auto &face = meshFaces[i];
-            for (VertId vertex : face.vertices)
-            {
-                vertexToFacesThreadLocal[vertex].insert(face.baricenter.id);
-            }
+            neighbors.insert(neighbors.end(), vertexFaces.begin() + vertexOffsets[vertex], vertexFaces.begin() + vertexOffsets[vertex + 1]);
         }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), FaceId(i)), neighbors.end());
+    };
 
-        #pragma omp critical
+    // First pass: number of neighbors of each face
+    adjacencyOffsets.assign(numFaces + 1, 0);
+    #pragma omp parallel
+    {
+        std::vector<FaceId> neighbors;
+        #pragma omp for
+        for (size_t i = 0; i < numFaces; i++)
         {
-            for (const auto &[vertex, faces] : vertexToFacesThreadLocal)
-            {
-                vertexToFaces[vertex].insert(faces.begin(), faces.end());
-            }
+            gatherNeighbors(i, neighbors);
+            adjacencyOffsets[i + 1] = static_cast<uint32_t>(neighbors.size());
         }
     }
+    for (size_t i = 0; i < numFaces; i++)
+    {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
 
-    std::vector<std::vector<FaceId>> tempFaceAdjacency(meshFaces.size());
+    // Second pass: every face writes its neighbors in its own slice
+    adjacencyIndices.resize(adjacencyOffsets[numFaces]);
+    adjacencyWeights.clear();
+    #pragma omp parallel
+    {
+        std::vector<FaceId> neighbors;
+        #pragma omp for
+        for (size_t i = 0; i < numFaces; i++)
+        {
+            gatherNeighbors(i, neighbors);
+            std::copy(neighbors.begin(), neighbors.end(), adjacencyIndices.begin() + adjacencyOffsets[i]);
+        }
+    }
+}
+
+void Mesh::buildFaceAdjacencyWeights(const std::function<double(FaceId, FaceId)> &weight)
+{
+    buildFaceAdjacency();
+
+    const size_t numFaces = meshFaces.size();
+    adjacencyWeights.resize(adjacencyIndices.size());
 
     #pragma omp parallel for
-    for (size_t i = 0; i < meshFaces.size(); i++)
+    for (size_t i = 0; i < numFaces; i++)
     {
-        const auto &face = meshFaces[i];
-        std::set<FaceId> adjacentFacesSet;
-
-        for (VertId vertex : face.vertices)
+        for (uint32_t e = adjacencyOffsets[i]; e < adjacencyOffsets[i + 1]; e++)
         {
-            const auto &connectedFaces = vertexToFaces[vertex];
-            adjacentFacesSet.insert(connectedFaces.begin(), connectedFaces.end());
+            adjacencyWeights[e] = weight(FaceId(i), adjacencyIndices[e]);
         }
+    }
+}
 
-        adjacentFacesSet.erase(face.baricenter.id);
-        tempFaceAdjacency[i] = std::vector<FaceId>(adjacentFacesSet.begin(), adjacentFacesSet.end());
+std::unordered_map<FaceId, std::vector<FaceId>> Mesh::getFaceAdjacency() const
+{
+    std::unordered_map<FaceId, std::vector<FaceId>> faceAdjacency;
+    if (adjacencyOffsets.empty())
+    {
+        return faceAdjacency;
     }
 
-    for (size_t i = 0; i < meshFaces.size(); i++)
+    for (FaceId faceId = 0; faceId < meshFaces.size(); ++faceId)
     {
-        faceAdjacency[meshFaces[i].baricenter.id] = std::move(tempFaceAdjacency[i]);
+        Span<const FaceId> neighbors = getFaceAdjacencyAt(faceId);
+        faceAdjacency[faceId] = std::vector<FaceId>(neighbors.begin(), neighbors.end());
     }
+    return faceAdjacency;
 }
 
 void Mesh::exportToObj(const std::string &filepath, int cluster)
@@ -178,16 +235,13 @@ void Mesh::exportToObj(const std::string &filepath, int cluster)
   std::cout << "Exported mesh to " << filepath << std::endl;
 }
 
-const int Mesh::getFaceCluster(FaceId face) const
+void Mesh::setFaceClusters(Span<const int32_t> clusters)
 {
-  try
-  {
-      return faceClusters.at(face);
-  }
-  catch (const std::out_of_range &e)
+  if (clusters.size() != meshFaces.size())
   {
-      return -1;
+    throw std::invalid_argument("The number of labels must match the number of faces");
   }
+  faceClusters.assign(clusters.begin(), clusters.end());
 }
 
 std::vector<Point<double, 3>> Mesh::getMeshFacesPoints()
@@ -248,6 +302,34 @@ void Mesh::exportToGroupedObj(const std::string &filepath) const
   std::cout << "Exported grouped mesh to " << filepath << std::endl;
 }
 
+uint64_t Mesh::contentHash() const
+{
+  uint64_t hash = 14695981039346656037ULL; // FNV-1a offset basis
+  auto combine = [&hash](const void *data, size_t size)
+  {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL; // FNV-1a prime
+    }
+  };
+
+  const uint64_t numVertices = meshVertices.size();
+  const uint64_t numFaces = meshFaces.size();
+  combine(&numVertices, sizeof(numVertices));
+  combine(&numFaces, sizeof(numFaces));
+  for (const auto &vertex : meshVertices)
+  {
+    combine(vertex.coordinates.data(), sizeof(double) * vertex.coordinates.size());
+  }
+  for (const auto &face : meshFaces)
+  {
+    combine(face.vertices.data(), sizeof(VertId) * face.vertices.size());
+  }
+  return hash;
+}
+
 void Mesh::addVertex(const Point<double, 3> &vertex)
 {
   meshVertices.push_back(vertex);
@@ -256,4 +338,10 @@ void Mesh::addVertex(const Point<double, 3> &vertex)
 void Mesh::addFace(const Face &face)
 {
   meshFaces.push_back(face);
+  faceClusters.resize(meshFaces.size(), UNASSIGNED_CLUSTER);
+
+  // The adjacency no longer matches the faces
+  adjacencyOffsets.clear();
+  adjacencyIndices.clear();
+  adjacencyWeights.clear();
 }
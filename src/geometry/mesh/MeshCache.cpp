@@ -0,0 +1,219 @@
+#include "geometry/mesh/MeshCache.hpp"
+#include "utils/MappedFile.hpp"
+
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+  constexpr char MAGIC[4] = {'K', 'M', 'S', 'H'};
+
+  /**
+   * \brief Fixed-size header at the start of a .kmesh file.
+   */
+  struct Header
+  {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint64_t numVertices;
+    uint64_t numFaces;
+    uint64_t numAdjacency;
+  };
+  static_assert(sizeof(Header) == 48, "The header must not contain padding");
+
+  /**
+   * \brief Size of the file holding a mesh with the sizes of a header.
+   */
+  uint64_t fileSize(const Header &header)
+  {
+    const uint64_t V = header.numVertices;
+    const uint64_t F = header.numFaces;
+    return sizeof(Header)
+        + BinaryCache::padded(sizeof(double) * 3 * V)
+        + BinaryCache::padded(sizeof(uint32_t) * 3 * F)
+        + BinaryCache::padded(sizeof(double) * 3 * F) * 2
+        + BinaryCache::padded(sizeof(double) * F)
+        + BinaryCache::padded(sizeof(uint32_t) * (F + 1))
+        + BinaryCache::padded(sizeof(FaceId) * header.numAdjacency);
+  }
+
+  std::atomic<bool> enabled{true};
+}
+
+bool MeshCache::save(Mesh &mesh, const std::filesystem::path &path, const BinaryCache::SourceStamp &source)
+{
+  for (const Face &face : mesh.meshFaces)
+  {
+    if (face.vertices.size() != 3)
+    {
+      return false; // Only triangle meshes have a fixed-size record per face
+    }
+  }
+  mesh.buildFaceAdjacency();
+
+  const size_t numVertices = mesh.meshVertices.size();
+  const size_t numFaces = mesh.meshFaces.size();
+
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.sourceSize = source.size;
+  header.sourceTime = source.time;
+  header.numVertices = numVertices;
+  header.numFaces = numFaces;
+  header.numAdjacency = mesh.adjacencyIndices.size();
+
+  // Flattens the per-face data in the layout of the file
+  std::vector<double> vertices(3 * numVertices);
+  for (size_t v = 0; v < numVertices; v++)
+  {
+    std::copy(mesh.meshVertices[v].coordinates.begin(), mesh.meshVertices[v].coordinates.end(), vertices.begin() + 3 * v);
+  }
+  std::vector<uint32_t> faceVertices(3 * numFaces);
+  std::vector<double> baricenters(3 * numFaces);
+  std::vector<double> normals(3 * numFaces);
+  std::vector<double> areas(numFaces);
+  for (size_t f = 0; f < numFaces; f++)
+  {
+    const Face &face = mesh.meshFaces[f];
+    std::copy(face.vertices.begin(), face.vertices.end(), faceVertices.begin() + 3 * f);
+    std::copy(face.baricenter.coordinates.begin(), face.baricenter.coordinates.end(), baricenters.begin() + 3 * f);
+    std::copy(face.normal.coordinates.begin(), face.normal.coordinates.end(), normals.begin() + 3 * f);
+    areas[f] = face.area;
+  }
+
+  return BinaryCache::writeAtomically(path, [&](std::ofstream &out)
+  {
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    BinaryCache::writeArray(out, vertices.data(), sizeof(double) * vertices.size());
+    BinaryCache::writeArray(out, faceVertices.data(), sizeof(uint32_t) * faceVertices.size());
+    BinaryCache::writeArray(out, baricenters.data(), sizeof(double) * baricenters.size());
+    BinaryCache::writeArray(out, normals.data(), sizeof(double) * normals.size());
+    BinaryCache::writeArray(out, areas.data(), sizeof(double) * areas.size());
+    BinaryCache::writeArray(out, mesh.adjacencyOffsets.data(), sizeof(uint32_t) * mesh.adjacencyOffsets.size());
+    BinaryCache::writeArray(out, mesh.adjacencyIndices.data(), sizeof(FaceId) * mesh.adjacencyIndices.size());
+    return static_cast<bool>(out);
+  });
+}
+
+bool MeshCache::load(const std::filesystem::path &path, Mesh &mesh, const BinaryCache::SourceStamp *source)
+{
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(path, error))
+  {
+    return false;
+  }
+
+  try
+  {
+    MappedFile file(path.string());
+    Header header;
+    if (file.size() < sizeof(Header))
+    {
+      return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+    {
+      return false;
+    }
+    if (source != nullptr && !BinaryCache::isFresh(path, {header.sourceSize, header.sourceTime}, *source))
+    {
+      return false;
+    }
+    // Rejects sizes that would overflow the file size or the 32-bit ids before computing it
+    if (header.numVertices > UINT32_MAX || header.numFaces >= UINT32_MAX || header.numAdjacency > UINT32_MAX
+        || fileSize(header) != file.size())
+    {
+      return false;
+    }
+
+    const size_t numVertices = header.numVertices;
+    const size_t numFaces = header.numFaces;
+    std::vector<double> vertices(3 * numVertices);
+    std::vector<uint32_t> faceVertices(3 * numFaces);
+    std::vector<double> baricenters(3 * numFaces);
+    std::vector<double> normals(3 * numFaces);
+    std::vector<double> areas(numFaces);
+    std::vector<uint32_t> adjacencyOffsets(numFaces + 1);
+    std::vector<FaceId> adjacencyIndices(header.numAdjacency);
+
+    const char *cursor = file.data() + sizeof(Header);
+    cursor = BinaryCache::readArray(cursor, vertices.data(), sizeof(double) * vertices.size());
+    cursor = BinaryCache::readArray(cursor, faceVertices.data(), sizeof(uint32_t) * faceVertices.size());
+    cursor = BinaryCache::readArray(cursor, baricenters.data(), sizeof(double) * baricenters.size());
+    cursor = BinaryCache::readArray(cursor, normals.data(), sizeof(double) * normals.size());
+    cursor = BinaryCache::readArray(cursor, areas.data(), sizeof(double) * areas.size());
+    cursor = BinaryCache::readArray(cursor, adjacencyOffsets.data(), sizeof(uint32_t) * adjacencyOffsets.size());
+    BinaryCache::readArray(cursor, adjacencyIndices.data(), sizeof(FaceId) * adjacencyIndices.size());
+
+    // The arrays are trusted by the hot paths, so the indices are checked once here
+    for (uint32_t vertex : faceVertices)
+    {
+      if (vertex >= numVertices)
+      {
+        return false;
+      }
+    }
+    if (adjacencyOffsets[0] != 0 || adjacencyOffsets[numFaces] != header.numAdjacency)
+    {
+      return false;
+    }
+    for (size_t f = 0; f < numFaces; f++)
+    {
+      if (adjacencyOffsets[f] > adjacencyOffsets[f + 1])
+      {
+        return false;
+      }
+    }
+    for (FaceId neighbor : adjacencyIndices)
+    {
+      if (neighbor >= numFaces)
+      {
+        return false;
+      }
+    }
+
+    std::vector<Point<double, 3>> meshVertices(numVertices);
+    #pragma omp parallel for
+    for (size_t v = 0; v < numVertices; v++)
+    {
+      meshVertices[v] = Point<double, 3>({vertices[3 * v], vertices[3 * v + 1], vertices[3 * v + 2]}, static_cast<int>(v));
+    }
+
+    std::vector<Face> meshFaces(numFaces);
+    #pragma omp parallel for
+    for (size_t f = 0; f < numFaces; f++)
+    {
+      Face &face = meshFaces[f];
+      face.vertices.assign(faceVertices.begin() + 3 * f, faceVertices.begin() + 3 * f + 3);
+      face.area = areas[f];
+      face.baricenter = Point<double, 3>({baricenters[3 * f], baricenters[3 * f + 1], baricenters[3 * f + 2]}, static_cast<int>(f));
+      face.normal = Point<double, 3>({normals[3 * f], normals[3 * f + 1], normals[3 * f + 2]});
+    }
+
+    mesh.meshVertices = std::move(meshVertices);
+    mesh.meshFaces = std::move(meshFaces);
+    mesh.faceClusters.assign(numFaces, Mesh::UNASSIGNED_CLUSTER);
+    mesh.adjacencyOffsets = std::move(adjacencyOffsets);
+    mesh.adjacencyIndices = std::move(adjacencyIndices);
+    mesh.adjacencyWeights.clear();
+    return true;
+  }
+  catch (const std::exception &)
+  {
+    return false;
+  }
+}
+
+void MeshCache::setEnabled(bool value)
+{
+  enabled = value;
+}
+
+bool MeshCache::isEnabled()
+{
+  return enabled;
+}
@@ -0,0 +1,238 @@
+#include "geometry/mesh/ObjReader.hpp"
+#include "utils/CSVUtils.hpp"
+#include "utils/MappedFile.hpp"
+
+#include <omp.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+  enum class Statement
+  {
+    OTHER,
+    VERTEX,
+    FACE
+  };
+
+  bool isSpace(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  const char *skipSpaces(const char *cursor, const char *last)
+  {
+    while (cursor < last && isSpace(*cursor))
+    {
+      cursor++;
+    }
+    return cursor;
+  }
+
+  /**
+   * \brief Returns the kind of a line and moves the cursor after its keyword.
+   */
+  Statement statement(const char *&cursor, const char *last)
+  {
+    cursor = skipSpaces(cursor, last);
+    if (last - cursor < 2 || !isSpace(cursor[1]))
+    {
+      return Statement::OTHER;
+    }
+    const char keyword = cursor[0];
+    cursor += 2;
+    return keyword == 'v' ? Statement::VERTEX : keyword == 'f' ? Statement::FACE : Statement::OTHER;
+  }
+
+  /**
+   * \brief Moves the cursor to the next face vertex, returns false at the end of the line or at a comment.
+   */
+  bool nextToken(const char *&cursor, const char *last)
+  {
+    cursor = skipSpaces(cursor, last);
+    return cursor < last && *cursor != '#';
+  }
+
+  /**
+   * \brief Number of vertices of a face line, the cursor being after the keyword.
+   */
+  std::size_t countFaceVertices(const char *cursor, const char *last)
+  {
+    std::size_t count = 0;
+    while (nextToken(cursor, last))
+    {
+      count++;
+      while (cursor < last && !isSpace(*cursor))
+      {
+        cursor++;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * \brief Parses the vertex index of a face vertex and skips its texture and normal indices.
+   *
+   * \param cursor The first character of the face vertex, moved after it.
+   * \param last The end of the line.
+   * \param index The one-based index, negative if relative to the last vertex.
+   * \return False if the face vertex does not start with a non-zero integer.
+   */
+  bool parseIndex(const char *&cursor, const char *last, int64_t &index)
+  {
+    const bool negative = *cursor == '-';
+    if (*cursor == '-' || *cursor == '+')
+    {
+      cursor++;
+    }
+    const char *digits = cursor;
+    int64_t value = 0;
+    while (cursor < last && *cursor >= '0' && *cursor <= '9' && value <= INT64_C(1) << 40)
+    {
+      value = value * 10 + (*cursor - '0');
+      cursor++;
+    }
+    if (cursor == digits || value == 0 || (cursor < last && !isSpace(*cursor) && *cursor != '/'))
+    {
+      return false;
+    }
+    while (cursor < last && !isSpace(*cursor))
+    {
+      cursor++;
+    }
+    index = negative ? -value : value;
+    return true;
+  }
+}
+
+void ObjReader::read(const std::string &path, Mesh &mesh)
+{
+  MappedFile file(path);
+  file.adviseSequential();
+  const char *begin = file.data();
+  const char *end = begin + file.size();
+
+  // Chunks of at least MIN_CHUNK_BYTES, a few per thread to balance the load
+  const std::size_t bytes = file.size();
+  const std::size_t numChunks = std::max<std::size_t>(1, std::min<std::size_t>(bytes / MIN_CHUNK_BYTES, 4 * omp_get_max_threads()));
+  std::vector<const char *> bounds(numChunks + 1, end);
+  bounds[0] = begin;
+  for (std::size_t c = 1; c < numChunks; ++c)
+  {
+    const char *cursor = std::max(begin + bytes * c / numChunks, bounds[c - 1]);
+    bounds[c] = cursor == begin || cursor[-1] == '\n' ? cursor : CSVUtils::nextLine(cursor, end);
+  }
+
+  // First pass: number of vertices and triangles of every chunk
+  std::vector<std::size_t> vertexOffsets(numChunks + 1, 0);
+  std::vector<std::size_t> triangleOffsets(numChunks + 1, 0);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (std::size_t c = 0; c < numChunks; ++c)
+  {
+    std::size_t vertices = 0, triangles = 0;
+    for (const char *line = bounds[c], *next; line < bounds[c + 1]; line = next)
+    {
+      const char *last = CSVUtils::lineEnd(line, end, next);
+      const Statement kind = statement(line, last);
+      vertices += kind == Statement::VERTEX;
+      if (kind == Statement::FACE)
+      {
+        triangles += std::max<std::size_t>(countFaceVertices(line, last), 2) - 2;
+      }
+    }
+    vertexOffsets[c + 1] = vertices;
+    triangleOffsets[c + 1] = triangles;
+  }
+  for (std::size_t c = 0; c < numChunks; ++c)
+  {
+    vertexOffsets[c + 1] += vertexOffsets[c];
+    triangleOffsets[c + 1] += triangleOffsets[c];
+  }
+  const std::size_t numVertices = vertexOffsets[numChunks];
+  const std::size_t numTriangles = triangleOffsets[numChunks];
+  if (numTriangles == 0)
+  {
+    throw std::runtime_error("No face in OBJ file: " + path);
+  }
+  if (numVertices > UINT32_MAX || numTriangles > UINT32_MAX)
+  {
+    throw std::runtime_error("Too many vertices or faces in OBJ file: " + path);
+  }
+
+  // Second pass: every chunk writes its vertices and triangles at its offsets
+  std::vector<Point<double, 3>> meshVertices(numVertices);
+  std::vector<VertId> triangles(3 * numTriangles);
+  bool invalid = false;
+  #pragma omp parallel for schedule(dynamic, 1) reduction(|| : invalid)
+  for (std::size_t c = 0; c < numChunks; ++c)
+  {
+    std::size_t vertex = vertexOffsets[c];
+    std::size_t triangle = triangleOffsets[c];
+    for (const char *line = bounds[c], *next; line < bounds[c + 1] && !invalid; line = next)
+    {
+      const char *last = CSVUtils::lineEnd(line, end, next);
+      const Statement kind = statement(line, last);
+      if (kind == Statement::VERTEX)
+      {
+        // Extra values, such as a weight or a color, are ignored
+        std::array<double, 3> coords;
+        for (std::size_t d = 0; d < 3 && !invalid; d++)
+        {
+          invalid = !CSVUtils::parseNumber(line, last, coords[d]);
+        }
+        meshVertices[vertex] = Point<double, 3>(coords, static_cast<int>(vertex));
+        vertex++;
+      }
+      else if (kind == Statement::FACE)
+      {
+        VertId first = 0, previous = 0;
+        std::size_t count = 0;
+        for (; nextToken(line, last); count++)
+        {
+          int64_t index;
+          if (!parseIndex(line, last, index))
+          {
+            invalid = true;
+            break;
+          }
+          const int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(vertex) + index;
+          if (resolved < 0 || resolved >= static_cast<int64_t>(numVertices))
+          {
+            invalid = true;
+            break;
+          }
+
+          const VertId current = static_cast<VertId>(resolved);
+          if (count >= 2)
+          {
+            triangles[3 * triangle] = first;
+            triangles[3 * triangle + 1] = previous;
+            triangles[3 * triangle + 2] = current;
+            triangle++;
+          }
+          first = count == 0 ? current : first;
+          previous = current;
+        }
+        invalid = invalid || count < 3;
+      }
+    }
+  }
+  if (invalid)
+  {
+    throw std::runtime_error("Invalid vertex or face in OBJ file: " + path);
+  }
+
+  std::vector<Face> meshFaces(numTriangles);
+  #pragma omp parallel for
+  for (std::size_t f = 0; f < numTriangles; f++)
+  {
+    meshFaces[f] = Face({triangles[3 * f], triangles[3 * f + 1], triangles[3 * f + 2]}, meshVertices, FaceId(f));
+  }
+
+  mesh.meshVertices = std::move(meshVertices);
+  mesh.meshFaces = std::move(meshFaces);
+  mesh.faceClusters.assign(numTriangles, Mesh::UNASSIGNED_CLUSTER);
+  mesh.adjacencyOffsets.clear();
+  mesh.adjacencyIndices.clear();
+  mesh.adjacencyWeights.clear();
+}
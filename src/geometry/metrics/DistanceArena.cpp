@@ -0,0 +1,41 @@
+#include "geometry/metrics/DistanceArena.hpp"
+
+#include <algorithm>
+
+template <typename T>
+bool DistanceArena<T>::resize(std::size_t rows, std::size_t columns)
+{
+    if (buffer && rows == numRows && columns == numColumns)
+    {
+        return true;
+    }
+
+    // Rows are padded to whole cache lines, so every row keeps the alignment of the buffer
+    constexpr std::size_t ROW_ALIGNMENT = ALIGNMENT / sizeof(T);
+    const std::size_t stride = (columns + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+    const std::size_t required = rows * stride;
+    if (required > capacity || !buffer)
+    {
+        buffer.reset();
+        buffer.reset(static_cast<T *>(::operator new[](std::max<std::size_t>(required, 1) * sizeof(T), std::align_val_t(ALIGNMENT))));
+        capacity = required;
+    }
+    numRows = rows;
+    numColumns = columns;
+    rowStride = stride;
+    return false;
+}
+
+template <typename T>
+void DistanceArena<T>::release()
+{
+    buffer.reset();
+    capacity = 0;
+    numRows = 0;
+    numColumns = 0;
+    rowStride = 0;
+}
+
+// Explicit instantiation for supported types
+template class DistanceArena<float>;
+template class DistanceArena<double>;
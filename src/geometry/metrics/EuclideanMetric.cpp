@@ -2,37 +2,19 @@
 
 // Constructor
 template <typename PT, std::size_t PD>
-EuclideanMetric<PT, PD>::EuclideanMetric(std::vector<Point<PT, PD>> data, double threshold) {
-    this->data = data;
+EuclideanMetric<PT, PD>::EuclideanMetric(std::vector<Point<PT, PD>> data, double threshold, Engine engine)
+: engine(engine)
+{
+    this->setPoints(std::move(data));
     this->treshold = threshold;
-
-    #ifdef USE_CUDA
-        if (this->data.size() > MIN_NUM_POINTS_CUDA) {
-            kdtree = nullptr;
-        } else {
-            kdtree = std::make_unique<KdTree<PT, PD>>(this->data);
-        }
-    #else
-        kdtree = std::make_unique<KdTree<PT, PD>>(this->data);
-    #endif
 }
 
 template <typename PT, std::size_t PD>
-EuclideanMetric<PT, PD>::EuclideanMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data)
-: mesh(&mesh)
+EuclideanMetric<PT, PD>::EuclideanMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data, Engine engine)
+: mesh(&mesh), engine(engine)
 {
     this->treshold = percentage_threshold;
-    this->data = data;
-    
-    #ifdef USE_CUDA
-        if (this->data.size() > MIN_NUM_POINTS_CUDA) {
-            kdtree = nullptr;
-        } else {
-            kdtree = std::make_unique<KdTree<PT, PD>>(this->data);
-        }
-    #else
-        kdtree = std::make_unique<KdTree<PT, PD>>(this->data);
-    #endif
+    this->setPoints(std::move(data));
 }
 
 template<typename PT, std::size_t PD>
@@ -43,14 +25,7 @@ std::vector<Point<PT, PD>>& EuclideanMetric<PT, PD>::getPoints(){
 // Calculating the Euclidean distance between two points
 template <typename PT, std::size_t PD>
 PT EuclideanMetric<PT, PD>::distanceTo(const Point<PT, PD> &a, const Point<PT, PD> &b) {
-    if (a.coordinates.size() != b.coordinates.size()) {
-        throw std::invalid_argument("Points must have the same dimensionality");
-    }
-    PT sum = 0;
-    for (size_t i = 0; i < a.coordinates.size(); ++i) {
-        sum += std::pow(a.coordinates[i] - b.coordinates[i], 2);
-    }
-    return std::sqrt(sum);
+    return std::sqrt(squaredDistance(a, b));
 }
 
 // Setup method (does nothing for this metric)
@@ -60,10 +35,20 @@ void EuclideanMetric<PT, PD>::setup() {}
 // Execute clustering on CPU
 template <typename PT, std::size_t PD>
 void EuclideanMetric<PT, PD>::fit_cpu() {
+    const Engine selected = engine == Engine::AUTO ? selectEngine(this->pointSet.size(), this->centroids->size()) : engine;
+    if (selected == Engine::KDTREE_FILTER && !kdtree) {
+        kdtree = std::make_unique<KdTree<PT, PD>>(this->pointSet);
+    }
+    boundCenters.clear();
+
     bool convergence = false;
     int iter = 0;
     while (!convergence) {
-        filter();
+        if (selected == Engine::KDTREE_FILTER) {
+            filter();
+        } else {
+            boundedIteration(selected == Engine::ELKAN);
+        }
         convergence = checkConvergence(iter);
         this->oldCentroids = *this->centroids;
         setup();
@@ -102,8 +87,7 @@ void EuclideanMetric<PT, PD>::fit_gpu() {
 
     #pragma omp parallel for
     for (int i = 0; i < this->data.size(); i++) {
-        std::shared_ptr<CentroidPoint<PT, PD>> centroid_ptr = std::make_shared<CentroidPoint<PT, PD>>(this->centroids->at(cluster_assignment[i]));
-        this->data.at(i).setCentroid(centroid_ptr);
+        this->pointSet.setLabel(i, cluster_assignment[i]);
     }
 
     if (mesh != nullptr) {
@@ -117,104 +101,449 @@ void EuclideanMetric<PT, PD>::fit_gpu() {
 }
 #endif
 
+namespace {
+    // Index of the lowest set bit of a non-zero mask
+    inline int32_t lowestBit(uint64_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int32_t>(index);
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    // Calls a function with the label of every candidate, in increasing order
+    template <typename F>
+    inline void forEachCandidate(uint64_t candidates, F &&function) {
+        for (; candidates != 0; candidates &= candidates - 1) {
+            function(lowestBit(candidates));
+        }
+    }
+
+    template <typename List, typename F>
+    inline void forEachCandidate(const List &candidates, F &&function) {
+        for (int32_t c = 0; c < candidates.size; ++c) {
+            function(candidates.labels[c]);
+        }
+    }
+
+    inline bool hasSingleCandidate(uint64_t candidates) { return (candidates & (candidates - 1)) == 0; }
+
+    template <typename List>
+    inline bool hasSingleCandidate(const List &candidates) { return candidates.size == 1; }
+}
+
 // Filter the data
 template <typename PT, std::size_t PD>
 void EuclideanMetric<PT, PD>::filter() {
-    std::vector<std::shared_ptr<CentroidPoint<PT, PD>>> centersPointers;
-    for (CentroidPoint<PT, PD> &z : *this->centroids) {
-        z.resetCount();
-        centersPointers.push_back(std::shared_ptr<CentroidPoint<PT, PD>>(&z, [](CentroidPoint<PT, PD> *) {}));
+    const std::size_t numCentroids = this->centroids->size();
+
+    // One set of sums per thread, the centroids are only written after the traversal
+    const int numThreads = omp_get_max_threads();
+    threadSums.resize(numThreads);
+    for (auto &sums : threadSums) {
+        sums.assign(numCentroids, HasWgtCent<PT, PD>());
     }
+    taskDepth = numThreads > 1 ? static_cast<int>(std::ceil(std::log2(numThreads))) + TASK_DEPTH_SLACK : 0;
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(numThreads)
     {
         #pragma omp single
-        filterRecursive(kdtree->getRoot(), centersPointers, 0);
+        if (numCentroids <= MAX_MASK_CANDIDATES) {
+            const uint64_t all = numCentroids == 64 ? ~uint64_t(0) : (uint64_t(1) << numCentroids) - 1;
+            filterRecursive(0, all, 0, 1);
+        } else {
+            // The buffers only grow, a list never moves while the tasks reading it run
+            const std::size_t treeDepth = static_cast<std::size_t>(std::ceil(std::log2(std::max<std::size_t>(this->pointSet.size(), 2)))) + 1;
+            const std::size_t slotsSize = (std::size_t(1) << taskDepth) * numCentroids;
+            if (candidateSlots.size() < slotsSize) {
+                candidateSlots.resize(slotsSize);
+            }
+            candidateStacks.resize(numThreads);
+            for (auto &stack : candidateStacks) {
+                if (stack.size() < (treeDepth + 1) * numCentroids) {
+                    stack.resize((treeDepth + 1) * numCentroids);
+                }
+            }
+
+            // Slot 0 belongs to no node, it holds the list of all the centroids
+            for (std::size_t k = 0; k < numCentroids; ++k) {
+                candidateSlots[k] = static_cast<int32_t>(k);
+            }
+            filterRecursive(0, CandidateList{candidateSlots.data(), static_cast<int32_t>(numCentroids)}, 0, 1);
+        }
     }
 
-    for (CentroidPoint<PT, PD> &c : *this->centroids) {
+    for (std::size_t k = 0; k < numCentroids; ++k) {
+        CentroidPoint<PT, PD> &c = (*this->centroids)[k];
+        c.resetCount();
+        for (const auto &sums : threadSums) {
+            for (std::size_t i = 0; i < PD; ++i) {
+                c.wgtCent[i] += sums[k].wgtCent[i];
+            }
+            c.count += sums[k].count;
+        }
         c.normalize();
     }
 }
 
 // Recursively filter the data
 template <typename PT, std::size_t PD>
-void EuclideanMetric<PT, PD>::filterRecursive(std::unique_ptr<KdNode<PT, PD>> &node, const std::vector<std::shared_ptr<CentroidPoint<PT, PD>>> &candidates, int depth) {
-    if (!node) return;
-
-    if (!node->left && !node->right) {
-        auto zStar_ptr = findClosestCandidate(candidates, node->wgtCent);
-        *zStar_ptr = *zStar_ptr + *node;
-        node->myPoint->setCentroid(zStar_ptr);
+template <typename Candidates>
+void EuclideanMetric<PT, PD>::filterRecursive(int32_t nodeIndex, Candidates candidates, int depth, std::size_t slot) {
+    const KdNode<PT, PD> &node = kdtree->getNode(nodeIndex);
+
+    if (node.count == 1) {
+        const int32_t label = findClosestCandidate(candidates, node.wgtCent);
+        addToCentroid(label, node.wgtCent, node.count);
+        this->pointSet.setLabel(kdtree->getIndices()[node.begin], label);
         return;
     }
 
-    Point<PT, PD> cellMidpoint;
+    std::array<PT, PD> cellMidpoint;
+    for (std::size_t i = 0; i < PD; ++i) {
+        cellMidpoint[i] = (node.cellMin[i] + node.cellMax[i]) / PT(2);
+    }
+
+    const int32_t zStar = findClosestCandidate(candidates, cellMidpoint);
+    const Candidates filteredCandidates = pruneCandidates(candidates, zStar, node, depth, slot);
+
+    if (hasSingleCandidate(filteredCandidates)) {
+        addToCentroid(zStar, node.wgtCent, node.count);
+        assignCentroid(node, zStar);
+    } else if (node.isLeaf()) {
+        assignBucket(node, filteredCandidates);
+    } else if (depth < taskDepth) {
+        // The left subtree becomes a task, the candidates outlive it thanks to the taskwait
+        const int32_t left = node.left;
+        #pragma omp task firstprivate(left, filteredCandidates, depth, slot)
+        filterRecursive(left, filteredCandidates, depth + 1, 2 * slot);
+        filterRecursive(node.right, filteredCandidates, depth + 1, 2 * slot + 1);
+        #pragma omp taskwait
+    } else {
+        filterRecursive(node.left, filteredCandidates, depth + 1, 2 * slot);
+        filterRecursive(node.right, filteredCandidates, depth + 1, 2 * slot + 1);
+    }
+}
+
+// Keep the candidates that may own a point of the cell, as a bit mask
+template <typename PT, std::size_t PD>
+uint64_t EuclideanMetric<PT, PD>::pruneCandidates(uint64_t candidates, int32_t zStar, const KdNode<PT, PD> &node, int, std::size_t) {
+    const CentroidPoint<PT, PD> &closest = (*this->centroids)[zStar];
+    uint64_t filtered = 0;
+    forEachCandidate(candidates, [&](int32_t z) {
+        if (z == zStar || !isFarther((*this->centroids)[z], closest, node)) {
+            filtered |= uint64_t(1) << z;
+        }
+    });
+    return filtered;
+}
+
+// Keep the candidates that may own a point of the cell, as a list stored in the slot of the node
+// above the task depth, where tasks may read it from other threads, and in the stack of the thread below
+template <typename PT, std::size_t PD>
+typename EuclideanMetric<PT, PD>::CandidateList EuclideanMetric<PT, PD>::pruneCandidates(CandidateList candidates, int32_t zStar, const KdNode<PT, PD> &node, int depth, std::size_t slot) {
+    const std::size_t numCentroids = this->centroids->size();
+    int32_t *filtered = depth < taskDepth ? candidateSlots.data() + slot * numCentroids
+                                          : candidateStacks[omp_get_thread_num()].data() + (depth - taskDepth) * numCentroids;
+
+    const CentroidPoint<PT, PD> &closest = (*this->centroids)[zStar];
+    int32_t size = 0;
+    forEachCandidate(candidates, [&](int32_t z) {
+        if (z == zStar || !isFarther((*this->centroids)[z], closest, node)) {
+            filtered[size++] = z;
+        }
+    });
+    return CandidateList{filtered, size};
+}
+
+// Assign each point of a leaf bucket to its closest candidate with a vectorized distance kernel
+template <typename PT, std::size_t PD>
+template <typename Candidates>
+void EuclideanMetric<PT, PD>::assignBucket(const KdNode<PT, PD> &node, Candidates candidates) {
+    constexpr int32_t BLOCK_SIZE = 64;
+    const std::vector<int32_t> &indices = kdtree->getIndices();
+
+    // Coordinates in tree order: the points of the bucket are contiguous
+    std::array<const PT *, PD> coordinates;
     for (std::size_t i = 0; i < PD; ++i) {
-        cellMidpoint.setValue((node->cellMin[i] + node->cellMax[i]) / PT(2), i);
+        coordinates[i] = kdtree->getCoordinates(i);
+    }
+
+    for (int32_t blockBegin = node.begin; blockBegin < node.end; blockBegin += BLOCK_SIZE) {
+        const int32_t n = std::min(BLOCK_SIZE, node.end - blockBegin);
+        PT bestDistance[BLOCK_SIZE];
+        int32_t bestCandidate[BLOCK_SIZE];
+        for (int32_t j = 0; j < n; ++j) {
+            bestDistance[j] = std::numeric_limits<PT>::max();
+            bestCandidate[j] = 0;
+        }
+
+        // One candidate at a time against the whole block, the inner loop is branch-free
+        forEachCandidate(candidates, [&](int32_t c) {
+            const std::array<PT, PD> &centroid = (*this->centroids)[c].coordinates;
+            #pragma omp simd
+            for (int32_t j = 0; j < n; ++j) {
+                PT distance = 0;
+                for (std::size_t i = 0; i < PD; ++i) {
+                    const PT diff = coordinates[i][blockBegin + j] - centroid[i];
+                    distance += diff * diff;
+                }
+                const bool closer = distance < bestDistance[j];
+                bestDistance[j] = closer ? distance : bestDistance[j];
+                bestCandidate[j] = closer ? c : bestCandidate[j];
+            }
+        });
+
+        std::vector<HasWgtCent<PT, PD>> &sums = threadSums[omp_get_thread_num()];
+        for (int32_t j = 0; j < n; ++j) {
+            const int32_t label = bestCandidate[j];
+            for (std::size_t i = 0; i < PD; ++i) {
+                sums[label].wgtCent[i] += coordinates[i][blockBegin + j];
+            }
+            sums[label].count++;
+            this->pointSet.setLabel(indices[blockBegin + j], label);
+        }
     }
+}
 
-    auto zStar_ptr = findClosestCandidate(candidates, cellMidpoint);
-    std::vector<std::shared_ptr<CentroidPoint<PT, PD>>> filteredCandidates;
+// One iteration of Hamerly's or Elkan's algorithm over the flat point set
+template <typename PT, std::size_t PD>
+void EuclideanMetric<PT, PD>::boundedIteration(bool elkan) {
+    const std::size_t numPoints = this->pointSet.size();
+    const std::size_t numCentroids = this->centroids->size();
 
-    for (auto &z : candidates) {
-        if (z == zStar_ptr || !isFarther(*z, *zStar_ptr, *node)) {
-            filteredCandidates.push_back(z);
+    std::array<const PT *, PD> coordinates;
+    for (std::size_t d = 0; d < PD; ++d) {
+        coordinates[d] = this->pointSet.data(d);
+    }
+    std::vector<PT> centers(numCentroids * PD);
+    for (std::size_t j = 0; j < numCentroids; ++j) {
+        for (std::size_t d = 0; d < PD; ++d) {
+            centers[j * PD + d] = (*this->centroids)[j].coordinates[d];
+        }
+    }
+    auto distance = [&](std::size_t i, std::size_t j) {
+        PT sum = 0;
+        for (std::size_t d = 0; d < PD; ++d) {
+            const PT diff = coordinates[d][i] - centers[j * PD + d];
+            sum += diff * diff;
+        }
+        return std::sqrt(sum);
+    };
+
+    // Half the distance between every pair of centroids: a point closer than that to its
+    // centroid cannot be closer to the other one
+    std::vector<PT> halfDistances(numCentroids * numCentroids, 0);
+    std::vector<PT> halfMinDistance(numCentroids, std::numeric_limits<PT>::max());
+    for (std::size_t a = 0; a < numCentroids; ++a) {
+        for (std::size_t b = a + 1; b < numCentroids; ++b) {
+            PT sum = 0;
+            for (std::size_t d = 0; d < PD; ++d) {
+                const PT diff = centers[a * PD + d] - centers[b * PD + d];
+                sum += diff * diff;
+            }
+            const PT half = std::sqrt(sum) / PT(2);
+            halfDistances[a * numCentroids + b] = half;
+            halfDistances[b * numCentroids + a] = half;
+            halfMinDistance[a] = std::min(halfMinDistance[a], half);
+            halfMinDistance[b] = std::min(halfMinDistance[b], half);
         }
     }
 
-    if (filteredCandidates.size() == 1) {
-        *filteredCandidates[0] = *filteredCandidates[0] + *node;
-        assignCentroid(node->left, filteredCandidates[0]);
-        assignCentroid(node->right, filteredCandidates[0]);
+    // Drift of every centroid since the bounds were computed
+    const bool boundsValid = boundCenters.size() == centers.size() && upperBounds.size() == numPoints;
+    std::vector<PT> drift(numCentroids, 0);
+    std::size_t farthest = 0;
+    PT maxDrift = 0, secondDrift = 0;
+    if (boundsValid) {
+        for (std::size_t j = 0; j < numCentroids; ++j) {
+            PT sum = 0;
+            for (std::size_t d = 0; d < PD; ++d) {
+                const PT diff = centers[j * PD + d] - boundCenters[j * PD + d];
+                sum += diff * diff;
+            }
+            drift[j] = std::sqrt(sum);
+            if (drift[j] > maxDrift) {
+                secondDrift = maxDrift;
+                maxDrift = drift[j];
+                farthest = j;
+            } else if (drift[j] > secondDrift) {
+                secondDrift = drift[j];
+            }
+        }
     } else {
-        filterRecursive(node->left, filteredCandidates, depth + 1);
-        filterRecursive(node->right, filteredCandidates, depth + 1);
+        upperBounds.assign(numPoints, 0);
+        lowerBounds.assign(elkan ? numPoints * numCentroids : numPoints, 0);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (std::size_t i = 0; i < numPoints; ++i) {
+        int32_t label = this->pointSet.getLabel(i);
+        PT &upper = upperBounds[i];
+
+        if (elkan) {
+            PT *lower = &lowerBounds[i * numCentroids];
+            if (!boundsValid) {
+                label = 0;
+                upper = std::numeric_limits<PT>::max();
+                for (std::size_t j = 0; j < numCentroids; ++j) {
+                    lower[j] = distance(i, j);
+                    if (lower[j] < upper) {
+                        upper = lower[j];
+                        label = static_cast<int32_t>(j);
+                    }
+                }
+                this->pointSet.setLabel(i, label);
+                continue;
+            }
+
+            for (std::size_t j = 0; j < numCentroids; ++j) {
+                lower[j] = std::max(PT(0), lower[j] - drift[j]);
+            }
+            upper += drift[label];
+            if (upper <= halfMinDistance[label]) {
+                continue;
+            }
+
+            bool tight = false;
+            for (std::size_t j = 0; j < numCentroids; ++j) {
+                if (static_cast<int32_t>(j) == label || upper <= lower[j] || upper <= halfDistances[label * numCentroids + j]) {
+                    continue;
+                }
+                if (!tight) {
+                    upper = distance(i, label);
+                    lower[label] = upper;
+                    tight = true;
+                    if (upper <= lower[j] || upper <= halfDistances[label * numCentroids + j]) {
+                        continue;
+                    }
+                }
+                lower[j] = distance(i, j);
+                if (lower[j] < upper) {
+                    upper = lower[j];
+                    label = static_cast<int32_t>(j);
+                }
+            }
+            this->pointSet.setLabel(i, label);
+            continue;
+        }
+
+        PT &lower = lowerBounds[i];
+        if (boundsValid) {
+            upper += drift[label];
+            lower -= static_cast<std::size_t>(label) == farthest ? secondDrift : maxDrift;
+            const PT bound = std::max(halfMinDistance[label], lower);
+            if (upper <= bound) {
+                continue;
+            }
+            upper = distance(i, label);
+            if (upper <= bound) {
+                continue;
+            }
+        }
+
+        // The bounds do not prove the assignment: find the closest and second closest centroids
+        PT best = std::numeric_limits<PT>::max(), second = std::numeric_limits<PT>::max();
+        label = 0;
+        for (std::size_t j = 0; j < numCentroids; ++j) {
+            const PT dj = distance(i, j);
+            if (dj < best) {
+                second = best;
+                best = dj;
+                label = static_cast<int32_t>(j);
+            } else if (dj < second) {
+                second = dj;
+            }
+        }
+        upper = best;
+        lower = second;
+        this->pointSet.setLabel(i, label);
+    }
+
+    // Recompute the centroids from the labels, with per-thread sums
+    for (CentroidPoint<PT, PD> &c : *this->centroids) {
+        c.resetCount();
     }
+    #pragma omp parallel
+    {
+        std::vector<PT> sums(numCentroids * PD, 0);
+        std::vector<int> counts(numCentroids, 0);
+
+        #pragma omp for schedule(static) nowait
+        for (std::size_t i = 0; i < numPoints; ++i) {
+            const int32_t label = this->pointSet.getLabel(i);
+            for (std::size_t d = 0; d < PD; ++d) {
+                sums[label * PD + d] += coordinates[d][i];
+            }
+            counts[label]++;
+        }
+
+        #pragma omp critical
+        for (std::size_t j = 0; j < numCentroids; ++j) {
+            CentroidPoint<PT, PD> &c = (*this->centroids)[j];
+            for (std::size_t d = 0; d < PD; ++d) {
+                c.wgtCent[d] += sums[j * PD + d];
+            }
+            c.count += counts[j];
+        }
+    }
+
+    // An empty cluster keeps its centroid
+    for (CentroidPoint<PT, PD> &c : *this->centroids) {
+        if (c.count > 0) {
+            c.normalize();
+        }
+    }
+    boundCenters = std::move(centers);
 }
 
-// Find the closest candidate
+// Add the weighted centroid of a group of points to the sums of the calling thread
 template <typename PT, std::size_t PD>
-std::shared_ptr<CentroidPoint<PT, PD>> EuclideanMetric<PT, PD>::findClosestCandidate(const std::vector<std::shared_ptr<CentroidPoint<PT, PD>>> &candidates, const Point<PT, PD> &target) {
-    auto closest = candidates[0];
-    double minDist = this->distanceTo(*closest, target);
+void EuclideanMetric<PT, PD>::addToCentroid(int32_t label, const std::array<PT, PD> &wgtCent, int count) {
+    HasWgtCent<PT, PD> &sums = threadSums[omp_get_thread_num()][label];
+    for (std::size_t i = 0; i < PD; ++i) {
+        sums.wgtCent[i] += wgtCent[i];
+    }
+    sums.count += count;
+}
 
-    for (const auto &candidate : candidates) {
-        double dist = this->distanceTo(*candidate, target);
-        if (dist < minDist) {
+// Find the closest candidate
+template <typename PT, std::size_t PD>
+template <typename Candidates>
+int32_t EuclideanMetric<PT, PD>::findClosestCandidate(Candidates candidates, const std::array<PT, PD> &target) const {
+    int32_t closest = -1;
+    PT minDist = std::numeric_limits<PT>::max();
+    forEachCandidate(candidates, [&](int32_t candidate) {
+        const PT dist = squaredDistance((*this->centroids)[candidate].coordinates, target);
+        if (closest < 0 || dist < minDist) {
             minDist = dist;
             closest = candidate;
         }
-    }
+    });
     return closest;
 }
 
 // Check if a point is farther than another
 template <typename PT, std::size_t PD>
 bool EuclideanMetric<PT, PD>::isFarther(const Point<PT, PD> &z, const Point<PT, PD> &zStar, const KdNode<PT, PD> &node) {
-    Point<PT, PD> u = z - zStar;
-    Point<PT, PD> vH;
-
+    // Vertex of the cell in the direction of z - zStar
+    std::array<PT, PD> vH;
     for (std::size_t i = 0; i < PD; ++i) {
-        vH.setValue((u.getValues()[i] >= 0) ? node.cellMax[i] : node.cellMin[i], i);
+        vH[i] = (z.coordinates[i] - zStar.coordinates[i] >= 0) ? node.cellMax[i] : node.cellMin[i];
     }
 
-    double distZ = this->distanceTo(z, vH);
-    double distZStar = this->distanceTo(zStar, vH);
-
-    return distZ > distZStar;
+    return squaredDistance(z.coordinates, vH) > squaredDistance(zStar.coordinates, vH);
 }
 
-// Assign a centroid to the leaf nodes
+// Assign a centroid to all the points of a node
 template <typename PT, std::size_t PD>
-void EuclideanMetric<PT, PD>::assignCentroid(std::unique_ptr<KdNode<PT, PD>> &node, const std::shared_ptr<CentroidPoint<PT, PD>> &centroid) {
-    if (!node->left && !node->right) {
-        node->myPoint->setCentroid(centroid);
-        return;
+void EuclideanMetric<PT, PD>::assignCentroid(const KdNode<PT, PD> &node, int32_t label) {
+    const std::vector<int32_t> &indices = kdtree->getIndices();
+    for (int32_t j = node.begin; j < node.end; ++j) {
+        this->pointSet.setLabel(indices[j], label);
     }
-
-    assignCentroid(node->left, centroid);
-    assignCentroid(node->right, centroid);
 }
 
 // Check if the centroids have converged
@@ -257,25 +586,32 @@ void EuclideanMetric<double, 2>::storeCentroids() {}
 
 template <typename PT, std::size_t PD>
 void EuclideanMetric<PT, PD>::updateFaceClusters() {
+    if (mesh == nullptr) return;
+
     const size_t numFaces = mesh->numFaces();
     const size_t numCentroids = this->centroids->size();
     
+    std::vector<int32_t> labels(numFaces);
+
     // For each face, find the closest centroid based on the euclidean distance
+    #pragma omp parallel for
     for (FaceId faceId = 0; faceId < numFaces; ++faceId) {
         double minDistance = std::numeric_limits<double>::max();
         int closestCentroid = -1;
         const Point<PT, PD>& faceCenter = mesh->getFace(faceId).baricenter;
         
         for (size_t i = 0; i < numCentroids; ++i) {
-            double distance = this->distanceTo(faceCenter, (*this->centroids)[i]);
+            double distance = squaredDistance(faceCenter, (*this->centroids)[i]);
             if (distance < minDistance) {
                 minDistance = distance;
                 closestCentroid = static_cast<int>(i);
             }
         }
         
-        mesh->setFaceCluster(faceId, closestCentroid);
+        labels[faceId] = closestCentroid;
     }
+
+    mesh->setFaceClusters(labels);
 }
 
 template <>
@@ -2,12 +2,49 @@
 
 #define MAX_ITERATIONS 200
 
+void DijkstraWorkspace::reset(std::size_t numFaces)
+{
+  if (settled.size() != numFaces)
+  {
+    settled.assign(numFaces, 0);
+    epoch = 0;
+  }
+  // On overflow the stamps of old searches could match again, so they are cleared
+  if (++epoch == 0)
+  {
+    std::fill(settled.begin(), settled.end(), 0);
+    epoch = 1;
+  }
+  heap.clear();
+}
+
+thread_local DijkstraWorkspace dijkstraWorkspace;
+
+namespace
+{
+  /**
+   * \brief Converts a distance field to the storage type of an arena row.
+   *
+   * Distances beyond the range of the storage type, such as the maximum marking the
+   * unreachable faces, become its maximum.
+   */
+  template <typename ST, typename PT>
+  void copyField(const std::vector<PT> &field, ST *row)
+  {
+    constexpr PT LIMIT = static_cast<PT>(std::numeric_limits<ST>::max());
+    for (size_t faceId = 0; faceId < field.size(); ++faceId)
+    {
+      row[faceId] = field[faceId] < LIMIT ? static_cast<ST>(field[faceId]) : std::numeric_limits<ST>::max();
+    }
+  }
+}
+
 template <typename PT, std::size_t PD>
 GeodesicDijkstraMetric<PT, PD>::GeodesicDijkstraMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data)
     : mesh(&mesh)
 {
   this->threshold = percentage_threshold;
-  this->data = data;
+  this->setPoints(std::move(data));
 }
 
 template <typename PT, std::size_t PD>
@@ -23,7 +60,7 @@ double GeodesicDijkstraMetric<PT, PD>::setupAvg(){
       const auto& currFace = mesh->getFace(currentId);
       const auto& currBaricenter = currFace.baricenter;
 
-      const std::vector<FaceId>& adjacentFaces = mesh->getFaceAdjacencyAt(currentId);
+      Span<const FaceId> adjacentFaces = mesh->getFaceAdjacencyAt(currentId);
 
       for (size_t faceIdy = 0; faceIdy < adjacentFaces.size(); ++faceIdy) {
           if (currentId < adjacentFaces[faceIdy]) { 
@@ -72,58 +109,145 @@ double GeodesicDijkstraMetric<PT, PD>::dihedralAngle(const Face& f1, const Face&
 
 
 template <typename PT, std::size_t PD>
-void GeodesicDijkstraMetric<PT, PD>::setup()
+void GeodesicDijkstraMetric<PT, PD>::setupAdjacency()
 {
+  mesh->buildFaceAdjacency();
   this->avgDistances = setupAvg();
-  #pragma omp parallel for
+  // The centroids are snapped in parallel loops, the index is built before them
+  getFaceIndex();
+
+  // Edge weight: distance between the baricenters plus the dihedral term
+  mesh->buildFaceAdjacencyWeights([this](FaceId from, FaceId to)
+  {
+    const Face &fromFace = mesh->getFace(from);
+    const Face &toFace = mesh->getFace(to);
+    return computeEuclideanDistance(fromFace.baricenter, toFace.baricenter) + dihedralAngle(fromFace, toFace);
+  });
+
+  double weightSum = 0.0;
+  size_t numEdges = 0;
+  #pragma omp parallel for reduction(+:weightSum, numEdges)
+  for (FaceId faceId = 0; faceId < mesh->numFaces(); ++faceId)
+  {
+    for (double weight : mesh->getFaceAdjacencyWeightsAt(faceId))
+    {
+      weightSum += weight;
+      numEdges++;
+    }
+  }
+  this->avgEdgeWeight = numEdges > 0 ? weightSum / numEdges : 0.0;
+}
+
+template <typename PT, std::size_t PD>
+void GeodesicDijkstraMetric<PT, PD>::setup()
+{
+  this->seeds.resize(this->centroids->size());
+  prepareFields();
+  const bool parallelSearch = useParallelSearch();
+  auto compute = [this, parallelSearch](FaceId seed)
+  {
+    return parallelSearch ? computeDistancesDeltaStepping(seed) : computeDistances(seed);
+  };
+
+  // With delta-stepping every field already uses all the threads
+  #pragma omp parallel for if(!parallelSearch)
   for (int centroidId = 0; centroidId < this->centroids->size(); ++centroidId)
   {
     const auto &centroid = this->centroids->at(centroidId);
     FaceId closestFaceId = findClosestFace(centroid);
+    this->seeds[centroidId] = closestFaceId;
     // set the coordinates of the centroid as the baricenter of the closest face
     this->centroids->at(centroidId).coordinates = mesh->getFace(closestFaceId).baricenter.coordinates;
-    std::vector<PT> current_distances = computeDistances(closestFaceId);
-    this->distances[FaceId(centroidId)] = current_distances;
+    // the row is only rewritten if the centroid moved, and the field only computed if the face was not used as a seed recently
+    if (!retainField(centroidId, closestFaceId))
+    {
+      storeField(centroidId, closestFaceId, *distanceCache->getOrCompute(closestFaceId, compute));
+    }
   }
 }
 
 template <typename PT, std::size_t PD>
-FaceId GeodesicDijkstraMetric<PT, PD>::findClosestFace(const Point<PT, PD> &centroid) const
+void GeodesicDijkstraMetric<PT, PD>::setFloatDistances(bool enabled)
 {
-    double minDistance = std::numeric_limits<double>::max();
-    FaceId closestFaceId = -1;
+  if (enabled == floatStorage)
+  {
+    return;
+  }
+  floatStorage = enabled;
+  distances.release();
+  floatDistances.release();
+  fieldSeeds.clear();
+}
 
-    #pragma omp parallel
-    {
-        double localMinDistance = std::numeric_limits<double>::max();
-        FaceId localClosestFaceId = -1;
+template <typename PT, std::size_t PD>
+void GeodesicDijkstraMetric<PT, PD>::prepareFields()
+{
+  const size_t numCentroids = this->centroids->size();
+  const size_t numFaces = mesh->numFaces();
+  const bool kept = floatStorage ? floatDistances.resize(numCentroids, numFaces) : distances.resize(numCentroids, numFaces);
+  if (!kept || fieldSeeds.size() != numCentroids)
+  {
+    fieldSeeds.assign(numCentroids, NO_FIELD);
+  }
+  drift.assign(numCentroids, 0);
+  driftKnown = std::find(fieldSeeds.begin(), fieldSeeds.end(), NO_FIELD) == fieldSeeds.end();
+}
 
-        #pragma omp for nowait
-        for (FaceId faceId = 0; faceId < mesh->numFaces(); ++faceId)
-        {
-            const auto &face = mesh->getFace(faceId);
-            const auto &baricenter = face.baricenter;
+template <typename PT, std::size_t PD>
+bool GeodesicDijkstraMetric<PT, PD>::retainField(size_t centroidId, FaceId seed)
+{
+  const FaceId previousSeed = fieldSeeds[centroidId];
+  if (previousSeed == seed)
+  {
+    return true;
+  }
+  // The old field gives the distance the centroid travelled
+  if (previousSeed != NO_FIELD)
+  {
+    drift[centroidId] = floatStorage ? static_cast<PT>(floatDistances.row(centroidId)[seed]) : distances.row(centroidId)[seed];
+  }
+  return false;
+}
 
-            double distance = computeEuclideanDistance(centroid, baricenter);
+template <typename PT, std::size_t PD>
+void GeodesicDijkstraMetric<PT, PD>::storeField(size_t centroidId, FaceId seed, const std::vector<PT> &field)
+{
+  if (floatStorage)
+  {
+    copyField(field, floatDistances.row(centroidId));
+  }
+  else
+  {
+    copyField(field, distances.row(centroidId));
+  }
+  fieldSeeds[centroidId] = seed;
+}
 
-            if (distance < localMinDistance)
-            {
-                localMinDistance = distance;
-                localClosestFaceId = faceId;
-            }
-        }
+template <typename PT, std::size_t PD>
+FaceId GeodesicDijkstraMetric<PT, PD>::findClosestFace(const Point<PT, PD> &centroid) const
+{
+  return static_cast<FaceId>(getFaceIndex()->nearest(centroid.coordinates));
+}
 
-        #pragma omp critical
-        {
-            if (localMinDistance < minDistance)
-            {
-                minDistance = localMinDistance;
-                closestFaceId = localClosestFaceId;
-            }
-        }
+template <typename PT, std::size_t PD>
+std::shared_ptr<const KdTree<PT, PD>> GeodesicDijkstraMetric<PT, PD>::getFaceIndex() const
+{
+  std::lock_guard<std::mutex> lock(faceIndexMutex);
+  if (!faceIndex || faceIndex->getIndices().size() != static_cast<size_t>(mesh->numFaces()))
+  {
+    const size_t numFaces = mesh->numFaces();
+    PointSet<PT, PD> baricenters(numFaces);
+    #pragma omp parallel for
+    for (FaceId faceId = 0; faceId < numFaces; ++faceId)
+    {
+      for (std::size_t dim = 0; dim < PD; ++dim)
+      {
+        baricenters.data(dim)[faceId] = mesh->getFace(faceId).baricenter.coordinates[dim];
+      }
     }
-
-    return closestFaceId;
+    faceIndex = std::make_shared<const KdTree<PT, PD>>(baricenters);
+  }
+  return faceIndex;
 }
 
 
@@ -135,107 +259,228 @@ void GeodesicDijkstraMetric<PT, PD>::fit_cpu()
     throw std::runtime_error("Centroids not set!");
   }
 
+  bool hasConverged = false;
+  size_t iteration = 0;
+
+  setupAdjacency();
+  upperBounds.clear();
+  lowerBounds.clear();
+  fieldSeeds.clear();
+  assignmentStats.clear();
+
+  while (!hasConverged)
+  {
+    setup();
+    assignFaces();
+    updateCentroids();
+
+    hasConverged = checkConvergence(iteration);
+    this->oldCentroids = *this->centroids;
+    iteration++;
+  }
+  storeCentroids();
+  std::cout << "K-Means converged after " << iteration << " iterations." << std::endl;
+
+  size_t skipped = 0, total = 0;
+  for (const auto &stats : assignmentStats)
+  {
+    skipped += stats.skippedByBounds + stats.skippedAfterTightening;
+    total += stats.numFaces;
+  }
+  if (useBounds && total > 0)
+  {
+    std::cout << "Bounds skipped " << skipped << " of " << total << " face scans." << std::endl;
+  }
+}
+
+template <typename PT, std::size_t PD>
+size_t GeodesicDijkstraMetric<PT, PD>::assignFaces()
+{
+  return floatStorage ? assignFacesFrom(floatDistances) : assignFacesFrom(distances);
+}
+
+template <typename PT, std::size_t PD>
+template <typename ST>
+size_t GeodesicDijkstraMetric<PT, PD>::assignFacesFrom(const DistanceArena<ST> &arena)
+{
+  // Relative slack on the shifted bounds, the path sums of two fields are rounded differently,
+  // and the stored distances by up to the precision of the storage type
+  const PT BOUND_TOLERANCE = std::max<PT>(PT(1e-9), 4 * static_cast<PT>(std::numeric_limits<ST>::epsilon()));
+
   const size_t numFaces = mesh->numFaces();
   const size_t numCentroids = this->centroids->size();
 
-  std::vector<Point<PT, PD>> newCentroids(numCentroids);
+  std::vector<const ST *> fields(numCentroids);
+  for (size_t centroidIndex = 0; centroidIndex < numCentroids; ++centroidIndex)
+  {
+    fields[centroidIndex] = arena.row(centroidIndex);
+  }
 
-  bool hasConverged = false;
-  size_t iteration = 0;
+  // The bounds of the previous iteration are usable if the same centroids moved between known seeds
+  const bool boundsValid = useBounds && numCentroids > 1 &&
+                           upperBounds.size() == numFaces &&
+                           driftKnown && drift.size() == numCentroids;
 
-  mesh->buildFaceAdjacency();
+  // Drift of each centroid: geodesic distance between its previous and current seed, read by setup()
+  std::vector<PT> shift(numCentroids, 0);
+  PT maxDrift = 0;
+  if (boundsValid)
+  {
+    for (size_t centroidIndex = 0; centroidIndex < numCentroids; ++centroidIndex)
+    {
+      shift[centroidIndex] = drift[centroidIndex] * (1 + BOUND_TOLERANCE);
+      maxDrift = std::max(maxDrift, shift[centroidIndex]);
+    }
+  }
 
-  while (!hasConverged)
+  if (!boundsValid)
   {
-    unsigned int numChanged = 0;
-    hasConverged = true;
+    upperBounds.assign(numFaces, 0);
+    lowerBounds.assign(numFaces, 0);
+  }
 
-    setup();
+  Span<const int32_t> oldLabels = mesh->getFaceClusters();
+  std::vector<int32_t> labels(numFaces);
+  size_t numChanged = 0, skippedByBounds = 0, skippedAfterTightening = 0, fullScans = 0;
 
-    for (FaceId faceId = 0; faceId < numFaces; ++faceId)
+  #pragma omp parallel for reduction(+:numChanged, skippedByBounds, skippedAfterTightening, fullScans)
+  for (FaceId faceId = 0; faceId < numFaces; ++faceId)
+  {
+    const int32_t oldLabel = oldLabels[faceId];
+
+    if (boundsValid && oldLabel >= 0)
     {
-      double minDistance = std::numeric_limits<double>::max();
-      int closestCentroid = -1;
+      PT upper = upperBounds[faceId];
+      PT lower = lowerBounds[faceId];
+      if (maxDrift > 0)
+      {
+        upper = (upper + shift[oldLabel]) * (1 + BOUND_TOLERANCE);
+        lower = (lower - maxDrift) * (1 - BOUND_TOLERANCE);
+        upperBounds[faceId] = upper;
+        lowerBounds[faceId] = lower;
+      }
 
-      for (size_t centroidIndex = 0; centroidIndex < numCentroids; ++centroidIndex)
+      // A strict inequality keeps the lowest centroid on ties, like the full scan
+      if (upper < lower)
       {
-        double distance = this->distances[FaceId(centroidIndex)][faceId];
-        if (distance < minDistance)
-        {
-          minDistance = distance;
-          closestCentroid = centroidIndex;
-        }
+        labels[faceId] = oldLabel;
+        skippedByBounds++;
+        continue;
       }
 
-      if (mesh->getFaceCluster(faceId) != closestCentroid)
+      upper = fields[oldLabel][faceId];
+      upperBounds[faceId] = upper;
+      if (upper < lower)
       {
-        numChanged++;
-        mesh->setFaceCluster(faceId, closestCentroid);
+        labels[faceId] = oldLabel;
+        skippedAfterTightening++;
+        continue;
       }
     }
 
-    std::vector<size_t> counts(numCentroids, 0);
-    for (size_t i = 0; i < numCentroids; ++i)
+    double minDistance = std::numeric_limits<double>::max();
+    double secondDistance = std::numeric_limits<double>::max();
+    int closestCentroid = -1;
+
+    for (size_t centroidIndex = 0; centroidIndex < numCentroids; ++centroidIndex)
     {
-      newCentroids[i].coordinates.fill(0);
+      double distance = fields[centroidIndex][faceId];
+      if (distance < minDistance)
+      {
+        secondDistance = minDistance;
+        minDistance = distance;
+        closestCentroid = centroidIndex;
+      }
+      else if (distance < secondDistance)
+      {
+        secondDistance = distance;
+      }
     }
+    fullScans++;
 
-    #pragma omp parallel
+    labels[faceId] = closestCentroid;
+    upperBounds[faceId] = minDistance;
+    lowerBounds[faceId] = secondDistance;
+    if (oldLabel != closestCentroid)
     {
-        std::vector<Point<double,3>> localCentroids(newCentroids.size());
-        std::vector<int> localCounts(counts.size(), 0);
+      numChanged++;
+    }
+  }
+  mesh->setFaceClusters(labels);
 
-        #pragma omp for
-        for (FaceId faceId = 0; faceId < numFaces; ++faceId)
-        {
-            int centroidIndex = mesh->getFaceCluster(faceId);
-            const auto &baricenter = mesh->getFace(faceId).baricenter;
+  AssignmentStats stats;
+  stats.numFaces = numFaces;
+  stats.skippedByBounds = skippedByBounds;
+  stats.skippedAfterTightening = skippedAfterTightening;
+  stats.fullScans = fullScans;
+  stats.changed = numChanged;
+  assignmentStats.push_back(stats);
 
-            for (size_t dim = 0; dim < PD; ++dim)
-            {
-                localCentroids[centroidIndex].coordinates[dim] += baricenter.coordinates[dim];
-            }
-            localCounts[centroidIndex]++;
-        }
+  return numChanged;
+}
 
-        // Merge local results into global arrays
-        #pragma omp critical
-        {
-            for (size_t i = 0; i < newCentroids.size(); ++i)
-            {
-                for (size_t dim = 0; dim < PD; ++dim)
-                {
-                    newCentroids[i].coordinates[dim] += localCentroids[i].coordinates[dim];
-                }
-                counts[i] += localCounts[i];
-            }
-        }
-    }
+template <typename PT, std::size_t PD>
+void GeodesicDijkstraMetric<PT, PD>::updateCentroids()
+{
+  const size_t numFaces = mesh->numFaces();
+  const size_t numCentroids = this->centroids->size();
 
-    #pragma omp parallel for
-    for (size_t centroidIndex = 0; centroidIndex < numCentroids; ++centroidIndex)
-    {
-      if (counts[centroidIndex] > 0)
+  std::vector<Point<PT, PD>> newCentroids(numCentroids);
+  std::vector<size_t> counts(numCentroids, 0);
+  for (size_t i = 0; i < numCentroids; ++i)
+  {
+    newCentroids[i].coordinates.fill(0);
+  }
+
+  #pragma omp parallel
+  {
+      std::vector<Point<double,3>> localCentroids(newCentroids.size());
+      std::vector<int> localCounts(counts.size(), 0);
+
+      #pragma omp for
+      for (FaceId faceId = 0; faceId < numFaces; ++faceId)
       {
-        for (size_t dim = 0; dim < PD; ++dim)
-        {
-          newCentroids[centroidIndex].coordinates[dim] /= counts[centroidIndex];
-        }
+          int centroidIndex = mesh->getFaceCluster(faceId);
+          const auto &baricenter = mesh->getFace(faceId).baricenter;
+
+          for (size_t dim = 0; dim < PD; ++dim)
+          {
+              localCentroids[centroidIndex].coordinates[dim] += baricenter.coordinates[dim];
+          }
+          localCounts[centroidIndex]++;
       }
-    }
 
-    #pragma omp parallel for
-    for (size_t i = 0; i < numCentroids; ++i)
+      // Merge local results into global arrays
+      #pragma omp critical
+      {
+          for (size_t i = 0; i < newCentroids.size(); ++i)
+          {
+              for (size_t dim = 0; dim < PD; ++dim)
+              {
+                  newCentroids[i].coordinates[dim] += localCentroids[i].coordinates[dim];
+              }
+              counts[i] += localCounts[i];
+          }
+      }
+  }
+
+  #pragma omp parallel for
+  for (size_t centroidIndex = 0; centroidIndex < numCentroids; ++centroidIndex)
+  {
+    if (counts[centroidIndex] > 0)
     {
-      this->centroids->at(i).coordinates = newCentroids[i].coordinates;
+      for (size_t dim = 0; dim < PD; ++dim)
+      {
+        newCentroids[centroidIndex].coordinates[dim] /= counts[centroidIndex];
+      }
     }
+  }
 
-    hasConverged = checkConvergence(iteration);
-    this->oldCentroids = *this->centroids;
-    iteration++;
+  #pragma omp parallel for
+  for (size_t i = 0; i < numCentroids; ++i)
+  {
+    this->centroids->at(i).coordinates = newCentroids[i].coordinates;
   }
-  storeCentroids();
-  std::cout << "K-Means converged after " << iteration << " iterations." << std::endl;
 }
 
 // Controlla la convergenza
@@ -267,55 +512,156 @@ double GeodesicDijkstraMetric<PT, PD>::computeEuclideanDistance(const Point<PT,
 template <typename PT, std::size_t PD>
 std::vector<PT> GeodesicDijkstraMetric<PT, PD>::computeDistances(const FaceId startFace) const
 {
+  const size_t numFaces = mesh->numFaces();
 
   // Initialize Dijkstra's algorithm
-  std::vector<PT> curr_distances(mesh->numFaces()); // Minimum distance from startFace
-  std::unordered_map<FaceId, bool> visited;         // Keep track of visited faces
-  std::priority_queue<std::pair<PT, FaceId>, std::vector<std::pair<PT, FaceId>>, std::greater<>> pq;
-
-  // Initialize curr_distances and visited flags
-  for (int i = 0; i < mesh->numFaces(); ++i)
-  {
-    curr_distances[i] = std::numeric_limits<PT>::max();
-    visited[i] = false;
-  }
+  std::vector<PT> curr_distances(numFaces, std::numeric_limits<PT>::max()); // Minimum distance from startFace
+  DijkstraWorkspace &workspace = dijkstraWorkspace;
+  workspace.reset(numFaces);
 
   curr_distances[startFace] = 0;
-  pq.push({0, startFace});
+  workspace.heap.push(0, startFace);
 
   // Execute Dijkstra
-  while (!pq.empty())
+  while (!workspace.heap.empty())
   {
-    auto [currentDistance, currentFace] = pq.top();
-    pq.pop();
+    const FaceId currentFace = workspace.heap.pop().second;
 
     // Check if the face has already been visited
-    if (visited[currentFace])
+    if (workspace.isSettled(currentFace))
       continue;
-    visited[currentFace] = true;
+    workspace.settle(currentFace);
 
-    // Iterate over the neighbors of the current face
-    for (const auto &neighbor : mesh->getFaceAdjacencyAt(currentFace))
+    // Iterate over the neighbors of the current face, the edge weights are precomputed
+    const PT currentDistance = curr_distances[currentFace];
+    Span<const FaceId> neighbors = mesh->getFaceAdjacencyAt(currentFace);
+    Span<const double> weights = mesh->getFaceAdjacencyWeightsAt(currentFace);
+    for (std::size_t i = 0; i < neighbors.size(); ++i)
     {
-      const auto &neighborFace = mesh->getFace(neighbor);
-
-      // Compute distance between baricenters
-      const auto &currentBaricenter = mesh->getFace(currentFace).baricenter;
-      const auto &neighborBaricenter = neighborFace.baricenter;
-      PT weight = computeEuclideanDistance(currentBaricenter, neighborBaricenter) + dihedralAngle(mesh->getFace(currentFace), neighborFace);
+      const FaceId neighbor = neighbors[i];
+      const PT distance = currentDistance + static_cast<PT>(weights[i]);
 
       // Update the distance if a shorter path is found
-      if (curr_distances[currentFace] + weight < curr_distances[neighbor])
+      if (distance < curr_distances[neighbor])
+      {
+        curr_distances[neighbor] = distance;
+        workspace.heap.push(distance, neighbor);
+      }
+    }
+  }
+
+  return curr_distances;
+}
+
+template <typename PT, std::size_t PD>
+std::vector<PT> GeodesicDijkstraMetric<PT, PD>::computeDistancesDeltaStepping(const FaceId startFace) const
+{
+  const size_t numFaces = mesh->numFaces();
+  const PT delta = avgEdgeWeight > 0 ? static_cast<PT>(avgEdgeWeight) : PT(1);
+  auto bucketOf = [delta](PT distance) { return static_cast<size_t>(distance / delta); };
+
+  std::vector<std::atomic<PT>> tentative(numFaces);
+  #pragma omp parallel for
+  for (FaceId faceId = 0; faceId < numFaces; ++faceId)
+  {
+    tentative[faceId].store(std::numeric_limits<PT>::max(), std::memory_order_relaxed);
+  }
+  tentative[startFace].store(0, std::memory_order_relaxed);
+
+  std::vector<std::vector<FaceId>> buckets(1, std::vector<FaceId>{startFace});
+  std::vector<std::vector<std::pair<size_t, FaceId>>> requests(omp_get_max_threads());
+  std::vector<uint32_t> frontierStamp(numFaces, 0);
+  std::vector<FaceId> frontier;
+  uint32_t phase = 0;
+
+  for (size_t bucket = 0; bucket < buckets.size(); ++bucket)
+  {
+    // A bucket is processed until its faces stop improving each other
+    while (!buckets[bucket].empty())
+    {
+      // Keep each face once, and only if its distance still falls in this bucket
+      phase++;
+      frontier.clear();
+      for (FaceId face : buckets[bucket])
+      {
+        if (frontierStamp[face] != phase && bucketOf(tentative[face].load(std::memory_order_relaxed)) == bucket)
+        {
+          frontierStamp[face] = phase;
+          frontier.push_back(face);
+        }
+      }
+      buckets[bucket].clear();
+
+      #pragma omp parallel
+      {
+        auto &localRequests = requests[omp_get_thread_num()];
+
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < frontier.size(); ++i)
+        {
+          const FaceId face = frontier[i];
+          const PT currentDistance = tentative[face].load(std::memory_order_relaxed);
+          Span<const FaceId> neighbors = mesh->getFaceAdjacencyAt(face);
+          Span<const double> weights = mesh->getFaceAdjacencyWeightsAt(face);
+
+          for (std::size_t j = 0; j < neighbors.size(); ++j)
+          {
+            const FaceId neighbor = neighbors[j];
+            const PT distance = currentDistance + static_cast<PT>(weights[j]);
+
+            // Atomic minimum, another thread may be relaxing the same face
+            PT previous = tentative[neighbor].load(std::memory_order_relaxed);
+            while (distance < previous &&
+                   !tentative[neighbor].compare_exchange_weak(previous, distance, std::memory_order_relaxed))
+            {
+            }
+            if (distance < previous)
+            {
+              localRequests.push_back({bucketOf(distance), neighbor});
+            }
+          }
+        }
+      }
+
+      for (auto &localRequests : requests)
       {
-        curr_distances[neighbor] = curr_distances[currentFace] + weight;
-        pq.push({curr_distances[neighbor], neighbor});
+        for (const auto &[target, face] : localRequests)
+        {
+          if (target >= buckets.size())
+          {
+            buckets.resize(target + 1);
+          }
+          buckets[target].push_back(face);
+        }
+        localRequests.clear();
       }
     }
   }
 
+  std::vector<PT> curr_distances(numFaces);
+  #pragma omp parallel for
+  for (FaceId faceId = 0; faceId < numFaces; ++faceId)
+  {
+    curr_distances[faceId] = tentative[faceId].load(std::memory_order_relaxed);
+  }
+
   return curr_distances;
 }
 
+template <typename PT, std::size_t PD>
+bool GeodesicDijkstraMetric<PT, PD>::useParallelSearch() const
+{
+  switch (searchEngine)
+  {
+  case SearchEngine::DIJKSTRA:
+    return false;
+  case SearchEngine::DELTA_STEPPING:
+    return true;
+  default:
+    return this->centroids->size() < static_cast<size_t>(omp_get_max_threads());
+  }
+}
+
 #ifdef USE_CUDA
 template <typename PT, std::size_t PD>
 void GeodesicDijkstraMetric<PT, PD>::fit_gpu()
@@ -395,10 +741,7 @@ void GeodesicDijkstraMetric<PT, PD>::fit_gpu()
   }
 
   //     face cluster
-  for (int f = 0; f < numFaces; f++)
-  {
-    mesh->setFaceCluster(f, h_faceCluster[f]);
-  }
+  mesh->setFaceClusters(h_faceCluster);
 
   // store or print
   this->storeCentroids();
@@ -409,9 +752,15 @@ void GeodesicDijkstraMetric<PT, PD>::fit_gpu()
 template <typename PT, std::size_t PD>
 void GeodesicDijkstraMetric<PT, PD>::storeCentroids(){
   const size_t numFaces = mesh->numFaces();
+  if (this->pointSet.size() != numFaces)
+  {
+    getPoints();
+  }
+
   for (FaceId faceId = 0; faceId < numFaces; ++faceId)
   {
     int centroidIndex = mesh->getFaceCluster(faceId);
+    this->pointSet.setLabel(faceId, centroidIndex);
     Point<PT, PD>& baricenter = mesh->getFace(faceId).baricenter;
     CentroidPoint<PT, PD>& c = (this->centroids)->at(centroidIndex);
     baricenter.setCentroid(c);
@@ -427,6 +776,11 @@ std::vector<Point<PT, PD>>& GeodesicDijkstraMetric<PT, PD>::getPoints(){
     Point<PT, PD>& baricenter = mesh->getFace(faceId).baricenter;
     this->data.push_back(baricenter);
   }
+  // The baricenters never move, the point set only has to follow the number of faces
+  if (this->pointSet.size() != this->data.size())
+  {
+    this->pointSet = PointSet<PT, PD>(this->data);
+  }
   return this->data;
 }
 
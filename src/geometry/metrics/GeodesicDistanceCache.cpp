@@ -0,0 +1,130 @@
+#include "geometry/metrics/GeodesicDistanceCache.hpp"
+
+template <typename PT>
+GeodesicDistanceCache<PT>::GeodesicDistanceCache(std::size_t memoryBudget)
+    : memoryBudget(memoryBudget)
+{
+}
+
+template <typename PT>
+typename GeodesicDistanceCache<PT>::Field GeodesicDistanceCache<PT>::get(FaceId seed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(seed);
+    if (it == index.end())
+    {
+        misses++;
+        return nullptr;
+    }
+
+    // Move the entry to the front of the recency list
+    entries.splice(entries.begin(), entries, it->second);
+    hits++;
+    return it->second->field;
+}
+
+template <typename PT>
+typename GeodesicDistanceCache<PT>::Field GeodesicDistanceCache<PT>::put(FaceId seed, std::vector<PT> distances)
+{
+    const std::size_t bytes = distances.size() * sizeof(PT);
+    Field field = std::make_shared<const std::vector<PT>>(std::move(distances));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bytes > memoryBudget)
+    {
+        return field;
+    }
+
+    auto it = index.find(seed);
+    if (it != index.end())
+    {
+        // Another thread stored the same seed in the meantime, keep the cached field
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->field;
+    }
+
+    entries.push_front(Entry{seed, field, bytes});
+    index[seed] = entries.begin();
+    memoryUsage += bytes;
+    evict();
+    return field;
+}
+
+template <typename PT>
+typename GeodesicDistanceCache<PT>::Field GeodesicDistanceCache<PT>::getOrCompute(FaceId seed, const std::function<std::vector<PT>(FaceId)> &compute)
+{
+    Field field = get(seed);
+    if (field)
+    {
+        return field;
+    }
+    return put(seed, compute(seed));
+}
+
+template <typename PT>
+void GeodesicDistanceCache<PT>::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    memoryUsage = 0;
+}
+
+template <typename PT>
+void GeodesicDistanceCache<PT>::setMemoryBudget(std::size_t memoryBudget)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->memoryBudget = memoryBudget;
+    evict();
+}
+
+template <typename PT>
+std::size_t GeodesicDistanceCache<PT>::getMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryBudget;
+}
+
+template <typename PT>
+std::size_t GeodesicDistanceCache<PT>::getMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryUsage;
+}
+
+template <typename PT>
+std::size_t GeodesicDistanceCache<PT>::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+template <typename PT>
+std::size_t GeodesicDistanceCache<PT>::getHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+template <typename PT>
+std::size_t GeodesicDistanceCache<PT>::getMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+template <typename PT>
+void GeodesicDistanceCache<PT>::evict()
+{
+    while (memoryUsage > memoryBudget && !entries.empty())
+    {
+        const Entry &last = entries.back();
+        memoryUsage -= last.bytes;
+        index.erase(last.seed);
+        entries.pop_back();
+    }
+}
+
+// Explicit template instantiation
+template class GeodesicDistanceCache<double>;
+template class GeodesicDistanceCache<float>;
@@ -3,6 +3,40 @@
 template <typename PT, std::size_t PD>
 GeodesicHeatMetric<PT, PD>::GeodesicHeatMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data)
     : GeodesicDijkstraMetric<PT, PD>(mesh, percentage_threshold, data)
+{
+    // Heat distances only approximate a metric, the triangle inequality behind the bounds does not hold
+    this->useBounds = false;
+
+    // Meshes with the same geometry share the factorized systems
+    data_heat = HeatPrecomputeCache<PT>::global().getOrCompute(mesh.contentHash(), [&mesh]()
+    {
+        return assembleOperators(mesh);
+    });
+
+    // Averaging operator from the vertex distances to the face distances
+    std::vector<Eigen::Triplet<PT>> triplets;
+    triplets.reserve(3 * mesh.numFaces());
+    for (FaceId faceId = 0; faceId < mesh.numFaces(); ++faceId)
+    {
+        for (VertId vertex : mesh.getFace(faceId).vertices)
+        {
+            triplets.emplace_back(faceId, vertex, PT(1) / 3);
+        }
+    }
+    auto average = std::make_shared<FaceAverageOperator>(mesh.numFaces(), mesh.getVertices().size());
+    average->setFromTriplets(triplets.begin(), triplets.end());
+    faceAverage = std::move(average);
+}
+
+template <typename PT, std::size_t PD>
+typename GeodesicHeatMetric<PT, PD>::Workspace &GeodesicHeatMetric<PT, PD>::workspace()
+{
+    static thread_local Workspace instance;
+    return instance;
+}
+
+template <typename PT, std::size_t PD>
+typename HeatPrecomputeCache<PT>::Operators GeodesicHeatMetric<PT, PD>::assembleOperators(Mesh &mesh)
 {
     const std::vector<Point<double, 3>> vertices = mesh.getVertices();
     Eigen::MatrixXd V(vertices.size(), 3);
@@ -26,6 +60,7 @@ GeodesicHeatMetric<PT, PD>::GeodesicHeatMetric(Mesh &mesh, double percentage_thr
         }
     }
     
+    typename HeatPrecomputeCache<PT>::Operators operators;
     Eigen::SparseMatrix<PT> L, M;
     VectorXS dblA;
 
@@ -41,74 +76,171 @@ GeodesicHeatMetric<PT, PD>::GeodesicHeatMetric(Mesh &mesh, double percentage_thr
         igl::doublearea(V, F, dblA);
 
         #pragma omp single nowait
-        igl::grad(V, F, data_heat.Grad);
+        igl::grad(V, F, operators.Grad);
     }
 
     const PT h = igl::avg_edge_length(V, F);
     const PT t = h * h;
 
     assert(F.cols() == 3 && "Only triangles are supported");
-    data_heat.ng = data_heat.Grad.rows() / F.rows();
-    assert(data_heat.ng == 3 || data_heat.ng == 2);
-    data_heat.Div = -0.25 * data_heat.Grad.transpose() * dblA.colwise().replicate(data_heat.ng).asDiagonal();
+    operators.ng = operators.Grad.rows() / F.rows();
+    assert(operators.ng == 3 || operators.ng == 2);
+    operators.Div = -0.25 * operators.Grad.transpose() * dblA.colwise().replicate(operators.ng).asDiagonal();
 
-    Eigen::SparseMatrix<PT> Q = M - t * L;
+    operators.Q = M - t * L;
     Eigen::MatrixXi O;
     igl::boundary_facets(F, O);
-    igl::unique(O, data_heat.b);
-    
-    Eigen::SparseMatrix<PT> _;
-    bool success1 = false, success2 = false, success3 = false;
-    #pragma omp parallel sections
+    igl::unique(O, operators.b);
+
+    const Eigen::Matrix<PT, 1, Eigen::Dynamic> M_diag_tr = M.diagonal().transpose();
+    operators.Aeq = M_diag_tr.sparseView();
+    operators.Poisson = -0.5 * L;
+
+    return operators;
+}
+
+template <typename PT, std::size_t PD>
+void GeodesicHeatMetric<PT, PD>::setup()
+{
+    const size_t numCentroids = this->centroids->size();
+    std::vector<FaceId> &seeds = this->seeds;
+    seeds.resize(numCentroids);
+    this->prepareFields();
+
+    #pragma omp parallel for
+    for (int centroidId = 0; centroidId < numCentroids; ++centroidId)
+    {
+        seeds[centroidId] = this->findClosestFace(this->centroids->at(centroidId));
+        // set the coordinates of the centroid as the baricenter of the closest face
+        this->centroids->at(centroidId).coordinates = this->mesh->getFace(seeds[centroidId]).baricenter.coordinates;
+    }
+
+    // Collect the seeds whose field is neither in the arena nor cached, each one only once
+    std::vector<FaceId> missingSeeds;
+    std::unordered_map<FaceId, size_t> missingColumn;
+    for (size_t centroidId = 0; centroidId < numCentroids; ++centroidId)
     {
-        #pragma omp section
+        if (this->retainField(centroidId, seeds[centroidId]) || missingColumn.count(seeds[centroidId]) != 0)
         {
-            success1 = igl::min_quad_with_fixed_precompute(Q, Eigen::VectorXi(), _, true, data_heat.Neumann);
+            continue;
         }
-        
-        #pragma omp section
+        if (auto field = this->distanceCache->get(seeds[centroidId]))
         {
-            success2 = true;
-            if (data_heat.b.size() > 0)
-            {
-                success2 = igl::min_quad_with_fixed_precompute(Q, data_heat.b, _, true, data_heat.Dirichlet);
-            }
+            this->storeField(centroidId, seeds[centroidId], *field);
+            continue;
         }
+        missingColumn[seeds[centroidId]] = missingSeeds.size();
+        missingSeeds.push_back(seeds[centroidId]);
+    }
 
-        #pragma omp section
-        {
-            const Eigen::Matrix<PT, 1, Eigen::Dynamic> M_diag_tr = M.diagonal().transpose();
-            const Eigen::SparseMatrix<PT> Aeq = M_diag_tr.sparseView();
-            L *= -0.5;
-            success3 = igl::min_quad_with_fixed_precompute(L, Eigen::VectorXi(), Aeq, true, data_heat.Poisson);
-        }
+    if (missingSeeds.empty())
+    {
+        return;
     }
 
-    if (!success1 || !success2 || !success3)
+    // One heat solve for all the missing fields
+    std::vector<std::vector<PT>> fields = computeDistancesBatch(missingSeeds);
+    std::vector<typename GeodesicDistanceCache<PT>::Field> stored(fields.size());
+    for (size_t column = 0; column < fields.size(); ++column)
+    {
+        stored[column] = this->distanceCache->put(missingSeeds[column], std::move(fields[column]));
+    }
+    for (size_t centroidId = 0; centroidId < numCentroids; ++centroidId)
     {
-        throw std::runtime_error("Error in heat_geodesics_precompute");
+        auto it = missingColumn.find(seeds[centroidId]);
+        if (it != missingColumn.end() && this->fieldSeeds[centroidId] != seeds[centroidId])
+        {
+            this->storeField(centroidId, seeds[centroidId], *stored[it->second]);
+        }
     }
 }
 
 template <typename PT, std::size_t PD>
 std::vector<PT> GeodesicHeatMetric<PT, PD>::computeDistances(const FaceId startFace) const
 {
-    Eigen::VectorXi gamma(1); 
-    gamma << this->mesh->getFace(startFace).vertices[0];
-    Eigen::VectorXd dist;
-    igl::heat_geodesics_solve(data_heat, gamma, dist);
+    return computeDistancesBatch({startFace})[0];
+}
+
+template <typename PT, std::size_t PD>
+std::vector<std::vector<PT>> GeodesicHeatMetric<PT, PD>::computeDistancesBatch(const std::vector<FaceId> &startFaces) const
+{
+    const igl::HeatGeodesicsData<PT> &data = *data_heat;
+    const Eigen::Index numVertices = data.Grad.cols();
+    const Eigen::Index numSources = startFaces.size();
+    Workspace &ws = workspace();
+
+    // One indicator column per source, set on all the vertices of its face
+    ws.u0.setZero(numVertices, numSources);
+    for (Eigen::Index column = 0; column < numSources; ++column)
+    {
+        for (VertId vertex : this->mesh->getFace(startFaces[column]).vertices)
+        {
+            ws.u0(vertex, column) = 1;
+        }
+    }
 
-    std::vector<PT> distFaces(this->mesh->numFaces());
+    // Heat flow, averaging the Neumann and Dirichlet solutions on meshes with a boundary
+    igl::min_quad_with_fixed_solve(data.Neumann, ws.u0, Matrix(), Matrix(), ws.u);
+    if (data.Dirichlet.n != 0)
+    {
+        ws.boundaryValues.setZero(data.b.size(), numSources);
+        igl::min_quad_with_fixed_solve(data.Dirichlet, ws.u0, ws.boundaryValues, Matrix(), ws.uD);
+        ws.u = 0.5 * (ws.u + ws.uD);
+    }
+
+    // Normalized gradient of every column, the components of a face are ng blocks of m rows
+    ws.gradU.noalias() = data.Grad * ws.u;
+    const Eigen::Index m = data.Grad.rows() / data.ng;
     #pragma omp parallel for
-    for (FaceId faceId = 0; faceId < this->mesh->numFaces(); ++faceId)
+    for (Eigen::Index i = 0; i < m; ++i)
     {
-        const auto &face = this->mesh->getFace(faceId);
+        for (Eigen::Index column = 0; column < numSources; ++column)
+        {
+            // Scale by the largest component first, far from the source the gradient can underflow
+            PT ma = 0;
+            for (int d = 0; d < data.ng; ++d)
+            {
+                ma = std::max(ma, std::abs(ws.gradU(d * m + i, column)));
+            }
+            PT norm = 0;
+            for (int d = 0; d < data.ng; ++d)
+            {
+                const PT component = ws.gradU(d * m + i, column) / ma;
+                norm += component * component;
+            }
+            norm = ma * std::sqrt(norm);
 
-        for (int i = 0; i < 3; i++)
+            for (int d = 0; d < data.ng; ++d)
+            {
+                ws.gradU(d * m + i, column) = (ma == 0 || norm == 0 || norm != norm) ? 0 : ws.gradU(d * m + i, column) / norm;
+            }
+        }
+    }
+
+    // Poisson step
+    ws.divX.noalias() = data.Div * ws.gradU;
+    ws.divX *= -1;
+    ws.boundaryValues.setZero(1, numSources);
+    igl::min_quad_with_fixed_solve(data.Poisson, ws.divX, Matrix(), ws.boundaryValues, ws.D);
+
+    // Face distances as one product, then every column is shifted to zero on its source face
+    ws.faceDistances.noalias() = (*faceAverage) * ws.D;
+    std::vector<std::vector<PT>> distFaces(numSources);
+    for (Eigen::Index column = 0; column < numSources; ++column)
+    {
+        const auto &sourceVertices = this->mesh->getFace(startFaces[column]).vertices;
+        PT sourceDistance = 0;
+        for (VertId vertex : sourceVertices)
         {
-            distFaces[faceId] += dist[face.vertices[i]];
+            sourceDistance += ws.D(vertex, column);
         }
-        distFaces[faceId] /= 3;
+        sourceDistance /= sourceVertices.size();
+
+        // The field is flipped if the vertex distances are negative on average
+        const PT sign = ws.D.col(column).mean() < sourceDistance ? PT(-1) : PT(1);
+        distFaces[column].resize(ws.faceDistances.rows());
+        Eigen::Map<Eigen::Matrix<PT, Eigen::Dynamic, 1>>(distFaces[column].data(), distFaces[column].size()) =
+            sign * (ws.faceDistances.col(column).array() - sourceDistance).matrix();
     }
 
     return distFaces;
@@ -0,0 +1,102 @@
+#include "geometry/metrics/GeodesicVoronoiMetric.hpp"
+
+template <typename PT, std::size_t PD>
+GeodesicVoronoiMetric<PT, PD>::GeodesicVoronoiMetric(Mesh &mesh, double percentage_threshold, std::vector<Point<PT, PD>> data)
+    : GeodesicDijkstraMetric<PT, PD>(mesh, percentage_threshold, std::move(data))
+{
+}
+
+template <typename PT, std::size_t PD>
+void GeodesicVoronoiMetric<PT, PD>::setup()
+{
+  this->seeds.resize(this->centroids->size());
+
+  #pragma omp parallel for
+  for (int centroidId = 0; centroidId < this->centroids->size(); ++centroidId)
+  {
+    this->seeds[centroidId] = this->findClosestFace(this->centroids->at(centroidId));
+    // set the coordinates of the centroid as the baricenter of the closest face
+    this->centroids->at(centroidId).coordinates = this->mesh->getFace(this->seeds[centroidId]).baricenter.coordinates;
+  }
+}
+
+template <typename PT, std::size_t PD>
+size_t GeodesicVoronoiMetric<PT, PD>::assignFaces()
+{
+  const size_t numFaces = this->mesh->numFaces();
+  Span<const int32_t> oldLabels = this->mesh->getFaceClusters();
+
+  // Entries are ordered by distance and then by label, so ties go to the lowest centroid
+  using Entry = std::tuple<PT, int32_t, FaceId>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> pq;
+
+  seedDistances.assign(numFaces, std::numeric_limits<PT>::max());
+  labels.assign(numFaces, Mesh::UNASSIGNED_CLUSTER);
+
+  for (int32_t centroidId = 0; centroidId < static_cast<int32_t>(this->seeds.size()); ++centroidId)
+  {
+    const FaceId seed = this->seeds[centroidId];
+    if (labels[seed] == Mesh::UNASSIGNED_CLUSTER)
+    {
+      seedDistances[seed] = 0;
+      labels[seed] = centroidId;
+      pq.push({0, centroidId, seed});
+    }
+  }
+
+  // Execute Dijkstra from all the seeds at once, the label travels with the distance
+  while (!pq.empty())
+  {
+    auto [currentDistance, currentLabel, currentFace] = pq.top();
+    pq.pop();
+
+    // Skip the stale entries of faces already settled by a closer seed
+    if (currentDistance > seedDistances[currentFace] || currentLabel != labels[currentFace])
+      continue;
+
+    Span<const FaceId> neighbors = this->mesh->getFaceAdjacencyAt(currentFace);
+    Span<const double> weights = this->mesh->getFaceAdjacencyWeightsAt(currentFace);
+    for (std::size_t i = 0; i < neighbors.size(); ++i)
+    {
+      const FaceId neighbor = neighbors[i];
+      const PT distance = currentDistance + static_cast<PT>(weights[i]);
+
+      if (distance < seedDistances[neighbor] ||
+          (distance == seedDistances[neighbor] && currentLabel < labels[neighbor]))
+      {
+        seedDistances[neighbor] = distance;
+        labels[neighbor] = currentLabel;
+        pq.push({distance, currentLabel, neighbor});
+      }
+    }
+  }
+
+  size_t numChanged = 0;
+  #pragma omp parallel for reduction(+:numChanged)
+  for (FaceId faceId = 0; faceId < numFaces; ++faceId)
+  {
+    // Faces not reachable from any seed go to the first centroid, so every face has a valid cluster
+    if (labels[faceId] == Mesh::UNASSIGNED_CLUSTER)
+    {
+      labels[faceId] = 0;
+    }
+    if (oldLabels[faceId] != labels[faceId])
+    {
+      numChanged++;
+    }
+  }
+  this->mesh->setFaceClusters(labels);
+
+  return numChanged;
+}
+
+#ifdef USE_CUDA
+template <typename PT, std::size_t PD>
+void GeodesicVoronoiMetric<PT, PD>::fit_gpu()
+{
+  this->fit_cpu();
+}
+#endif
+
+// Explicit template instantiation
+template class GeodesicVoronoiMetric<double, 3>;
@@ -0,0 +1,320 @@
+#include "geometry/metrics/HeatPrecomputeCache.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+  constexpr uint32_t OPERATORS_MAGIC = 0x4B4D4854; // "KMHT"
+  constexpr uint32_t OPERATORS_VERSION = 1;
+
+  template <typename T>
+  void writeValue(std::ofstream &out, const T &value)
+  {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool readValue(std::ifstream &in, T &value)
+  {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+
+  template <typename PT>
+  void writeSparse(std::ofstream &out, Eigen::SparseMatrix<PT> matrix)
+  {
+    matrix.makeCompressed();
+    writeValue<int64_t>(out, matrix.rows());
+    writeValue<int64_t>(out, matrix.cols());
+    writeValue<int64_t>(out, matrix.nonZeros());
+    out.write(reinterpret_cast<const char *>(matrix.outerIndexPtr()), sizeof(int) * (matrix.outerSize() + 1));
+    out.write(reinterpret_cast<const char *>(matrix.innerIndexPtr()), sizeof(int) * matrix.nonZeros());
+    out.write(reinterpret_cast<const char *>(matrix.valuePtr()), sizeof(PT) * matrix.nonZeros());
+  }
+
+  template <typename PT>
+  bool readSparse(std::ifstream &in, Eigen::SparseMatrix<PT> &matrix)
+  {
+    int64_t rows, cols, nonZeros;
+    if (!readValue(in, rows) || !readValue(in, cols) || !readValue(in, nonZeros) ||
+        rows < 0 || cols < 0 || nonZeros < 0)
+    {
+      return false;
+    }
+
+    matrix.resize(rows, cols);
+    matrix.makeCompressed();
+    matrix.resizeNonZeros(nonZeros);
+    in.read(reinterpret_cast<char *>(matrix.outerIndexPtr()), sizeof(int) * (matrix.outerSize() + 1));
+    in.read(reinterpret_cast<char *>(matrix.innerIndexPtr()), sizeof(int) * nonZeros);
+    in.read(reinterpret_cast<char *>(matrix.valuePtr()), sizeof(PT) * nonZeros);
+    if (!in)
+    {
+      return false;
+    }
+
+    // Reject corrupted indices instead of reading out of bounds later
+    const int *outer = matrix.outerIndexPtr();
+    if (outer[0] != 0 || outer[matrix.outerSize()] != nonZeros)
+    {
+      return false;
+    }
+    for (int64_t i = 0; i < matrix.outerSize(); ++i)
+    {
+      if (outer[i] > outer[i + 1])
+      {
+        return false;
+      }
+    }
+    for (int64_t i = 0; i < nonZeros; ++i)
+    {
+      if (matrix.innerIndexPtr()[i] < 0 || matrix.innerIndexPtr()[i] >= matrix.innerSize())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+template <typename PT>
+HeatPrecomputeCache<PT> &HeatPrecomputeCache<PT>::global()
+{
+  static HeatPrecomputeCache<PT> cache;
+  return cache;
+}
+
+template <typename PT>
+HeatPrecomputeCache<PT>::HeatPrecomputeCache(std::size_t capacity)
+    : capacity(capacity)
+{
+}
+
+template <typename PT>
+typename HeatPrecomputeCache<PT>::Data HeatPrecomputeCache<PT>::get(uint64_t key)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = entries.begin(); it != entries.end(); ++it)
+  {
+    if (it->first == key)
+    {
+      // Move the entry to the front of the recency list
+      entries.splice(entries.begin(), entries, it);
+      return it->second;
+    }
+  }
+  return nullptr;
+}
+
+template <typename PT>
+typename HeatPrecomputeCache<PT>::Data HeatPrecomputeCache<PT>::getOrCompute(uint64_t key, const std::function<Operators()> &assemble)
+{
+  Data data = get(key);
+  if (data)
+  {
+    return data;
+  }
+
+  const std::filesystem::path diskDirectory = getDirectory();
+  Operators operators;
+  if (diskDirectory.empty() || !loadOperators(operatorsPath(diskDirectory, key), key, operators))
+  {
+    operators = assemble();
+    if (!diskDirectory.empty())
+    {
+      std::error_code error;
+      std::filesystem::create_directories(diskDirectory, error);
+      saveOperators(operatorsPath(diskDirectory, key), key, operators);
+    }
+  }
+  data = factorize(operators);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &entry : entries)
+  {
+    // Another thread stored the same mesh in the meantime, keep the cached data
+    if (entry.first == key)
+    {
+      return entry.second;
+    }
+  }
+  entries.emplace_front(key, data);
+  evict();
+  return data;
+}
+
+template <typename PT>
+void HeatPrecomputeCache<PT>::setDirectory(const std::filesystem::path &directory)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  this->directory = directory;
+}
+
+template <typename PT>
+std::filesystem::path HeatPrecomputeCache<PT>::getDirectory() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return directory;
+}
+
+template <typename PT>
+void HeatPrecomputeCache<PT>::setCapacity(std::size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  this->capacity = capacity;
+  evict();
+}
+
+template <typename PT>
+std::size_t HeatPrecomputeCache<PT>::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+template <typename PT>
+void HeatPrecomputeCache<PT>::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+}
+
+template <typename PT>
+typename HeatPrecomputeCache<PT>::Data HeatPrecomputeCache<PT>::factorize(const Operators &operators)
+{
+  auto data = std::make_shared<igl::HeatGeodesicsData<PT>>();
+  data->Grad = operators.Grad;
+  data->Div = operators.Div;
+  data->b = operators.b;
+  data->ng = operators.ng;
+
+  Eigen::SparseMatrix<PT> _;
+  bool success1 = false, success2 = false, success3 = false;
+  #pragma omp parallel sections
+  {
+    #pragma omp section
+    {
+      success1 = igl::min_quad_with_fixed_precompute(operators.Q, Eigen::VectorXi(), _, true, data->Neumann);
+    }
+
+    #pragma omp section
+    {
+      success2 = true;
+      if (operators.b.size() > 0)
+      {
+        success2 = igl::min_quad_with_fixed_precompute(operators.Q, operators.b, _, true, data->Dirichlet);
+      }
+    }
+
+    #pragma omp section
+    {
+      success3 = igl::min_quad_with_fixed_precompute(operators.Poisson, Eigen::VectorXi(), operators.Aeq, true, data->Poisson);
+    }
+  }
+
+  if (!success1 || !success2 || !success3)
+  {
+    throw std::runtime_error("Error in heat_geodesics_precompute");
+  }
+  return data;
+}
+
+template <typename PT>
+bool HeatPrecomputeCache<PT>::saveOperators(const std::filesystem::path &path, uint64_t key, const Operators &operators)
+{
+  std::filesystem::path temporaryPath = path;
+  temporaryPath += ".tmp";
+  {
+    std::ofstream out(temporaryPath, std::ios::binary);
+    if (!out)
+    {
+      return false;
+    }
+
+    writeValue(out, OPERATORS_MAGIC);
+    writeValue(out, OPERATORS_VERSION);
+    writeValue<uint32_t>(out, sizeof(PT));
+    writeValue(out, key);
+    writeValue<int32_t>(out, operators.ng);
+    writeSparse(out, operators.Grad);
+    writeSparse(out, operators.Div);
+    writeSparse(out, operators.Q);
+    writeSparse(out, operators.Poisson);
+    writeSparse(out, operators.Aeq);
+    writeValue<int64_t>(out, operators.b.size());
+    out.write(reinterpret_cast<const char *>(operators.b.data()), sizeof(int) * operators.b.size());
+    if (!out)
+    {
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error)
+  {
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+  return true;
+}
+
+template <typename PT>
+bool HeatPrecomputeCache<PT>::loadOperators(const std::filesystem::path &path, uint64_t key, Operators &operators)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+  {
+    return false;
+  }
+
+  uint32_t magic, version, scalarSize;
+  uint64_t storedKey;
+  int32_t ng;
+  if (!readValue(in, magic) || !readValue(in, version) || !readValue(in, scalarSize) ||
+      !readValue(in, storedKey) || !readValue(in, ng) ||
+      magic != OPERATORS_MAGIC || version != OPERATORS_VERSION || scalarSize != sizeof(PT) || storedKey != key)
+  {
+    return false;
+  }
+
+  Operators loaded;
+  loaded.ng = ng;
+  int64_t boundarySize;
+  if (!readSparse(in, loaded.Grad) || !readSparse(in, loaded.Div) || !readSparse(in, loaded.Q) ||
+      !readSparse(in, loaded.Poisson) || !readSparse(in, loaded.Aeq) ||
+      !readValue(in, boundarySize) || boundarySize < 0)
+  {
+    return false;
+  }
+  loaded.b.resize(boundarySize);
+  in.read(reinterpret_cast<char *>(loaded.b.data()), sizeof(int) * boundarySize);
+  if (!in)
+  {
+    return false;
+  }
+
+  operators = std::move(loaded);
+  return true;
+}
+
+template <typename PT>
+std::filesystem::path HeatPrecomputeCache<PT>::operatorsPath(const std::filesystem::path &directory, uint64_t key)
+{
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.heat", static_cast<unsigned long long>(key));
+  return directory / name;
+}
+
+template <typename PT>
+void HeatPrecomputeCache<PT>::evict()
+{
+  while (entries.size() > capacity)
+  {
+    entries.pop_back();
+  }
+}
+
+// Explicit template instantiation
+template class HeatPrecomputeCache<double>;
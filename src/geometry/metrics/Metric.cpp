@@ -7,11 +7,23 @@ template <typename PT, std::size_t PD>
 Metric<PT, PD>::Metric(std::vector<CentroidPoint<PT, PD>> &centroids) : centroids(&centroids) {}
 
 template <typename PT, std::size_t PD>
-Metric<PT, PD>::Metric(std::vector<CentroidPoint<PT, PD>> &centroids, std::vector<Point<PT, PD>> data) : centroids(&centroids), data(data) {}
+Metric<PT, PD>::Metric(std::vector<CentroidPoint<PT, PD>> &centroids, std::vector<Point<PT, PD>> data) : centroids(&centroids), data(std::move(data)), pointSet(this->data) {}
 
 template <typename PT, std::size_t PD>
 void Metric<PT, PD>::setPoints(std::vector<Point<PT, PD>> data){
-    this->data = data;
+    this->data = std::move(data);
+    this->pointSet = PointSet<PT, PD>(this->data);
+}
+
+template <typename PT, std::size_t PD>
+void Metric<PT, PD>::setPoints(PointSet<PT, PD> points){
+    this->pointSet = std::move(points);
+    this->data = this->pointSet.toPoints();
+}
+
+template <typename PT, std::size_t PD>
+PointSet<PT, PD>& Metric<PT, PD>::getPointSet(){
+    return this->pointSet;
 }
 
 template <typename PT, std::size_t PD>
@@ -34,6 +46,21 @@ void Metric<PT, PD>::resetCentroids() {
     for(Point<PT, PD> &p : this->data){
         p.centroid.reset();
     }
+    pointSet.resetLabels();
+}
+
+template <typename PT, std::size_t PD>
+const std::vector<int32_t>& Metric<PT, PD>::getAssignments() const {
+    return pointSet.getLabels();
+}
+
+template <typename PT, std::size_t PD>
+const CentroidPoint<PT, PD>* Metric<PT, PD>::getAssignedCentroid(std::size_t index) const {
+    const int32_t label = pointSet.getLabel(index);
+    if (label == PointSet<PT, PD>::UNASSIGNED || centroids == nullptr) {
+        return nullptr;
+    }
+    return &(*centroids)[label];
 }
 
 template class Metric<double, 2>;
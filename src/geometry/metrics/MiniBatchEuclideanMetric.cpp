@@ -0,0 +1,191 @@
+#include "geometry/metrics/MiniBatchEuclideanMetric.hpp"
+
+#include <array>
+#include <limits>
+#include <algorithm>
+
+template <typename PT, std::size_t PD>
+MiniBatchEuclideanMetric<PT, PD>::MiniBatchEuclideanMetric(std::vector<Point<PT, PD>> data, std::size_t batchSize, double threshold)
+    : batchSize(batchSize), treshold(threshold)
+{
+    this->setPoints(std::move(data));
+}
+
+template <typename PT, std::size_t PD>
+MiniBatchEuclideanMetric<PT, PD>::MiniBatchEuclideanMetric(std::shared_ptr<BatchSource<PT, PD>> source, std::size_t batchSize, double threshold, std::size_t sampleSize)
+    : source(std::move(source)), batchSize(batchSize), treshold(threshold)
+{
+    PointSet<PT, PD> sample;
+    this->source->nextBatch(sampleSize == 0 ? batchSize : sampleSize, sample);
+    this->source->rewind();
+    this->setPoints(std::move(sample));
+}
+
+template <typename PT, std::size_t PD>
+PT MiniBatchEuclideanMetric<PT, PD>::perCenterLearningRate(std::size_t, std::size_t batchCount, std::size_t totalCount)
+{
+    return static_cast<PT>(batchCount) / static_cast<PT>(totalCount);
+}
+
+template <typename PT, std::size_t PD>
+void MiniBatchEuclideanMetric<PT, PD>::setup() {}
+
+template <typename PT, std::size_t PD>
+void MiniBatchEuclideanMetric<PT, PD>::fit_cpu()
+{
+    std::vector<CentroidPoint<PT, PD>> &centroids = *this->centroids;
+    const std::size_t numCentroids = centroids.size();
+    counts.assign(numCentroids, 0);
+    iterations = 0;
+
+    PointSet<PT, PD> batch;
+    std::vector<PT> sums(numCentroids * PD);
+    std::vector<std::size_t> batchCounts(numCentroids);
+    double smoothedDrift = 0;
+
+    while (iterations < maxIterations)
+    {
+        const std::size_t n = nextBatch(batch);
+        if (n == 0)
+        {
+            break;
+        }
+        assignPoints(batch);
+
+        std::fill(sums.begin(), sums.end(), PT(0));
+        std::fill(batchCounts.begin(), batchCounts.end(), 0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const int32_t label = batch.getLabel(i);
+            for (std::size_t d = 0; d < PD; ++d)
+            {
+                sums[label * PD + d] += batch(i, d);
+            }
+            batchCounts[label]++;
+        }
+
+        // Move every centroid toward the mean of its points in the batch
+        double drift = 0;
+        for (std::size_t j = 0; j < numCentroids; ++j)
+        {
+            if (batchCounts[j] == 0)
+            {
+                continue;
+            }
+            counts[j] += batchCounts[j];
+            const PT rate = learningRate(iterations, batchCounts[j], counts[j]);
+
+            PT squaredStep = 0;
+            for (std::size_t d = 0; d < PD; ++d)
+            {
+                const PT step = rate * (sums[j * PD + d] / batchCounts[j] - centroids[j].coordinates[d]);
+                centroids[j].coordinates[d] += step;
+                squaredStep += step * step;
+            }
+            drift += std::sqrt(squaredStep);
+        }
+        drift /= numCentroids;
+
+        smoothedDrift = iterations == 0 ? drift : (1 - DRIFT_SMOOTHING) * smoothedDrift + DRIFT_SMOOTHING * drift;
+        iterations++;
+        if (smoothedDrift <= treshold)
+        {
+            break;
+        }
+    }
+
+    assignPoints(this->pointSet);
+    storeCentroids();
+}
+
+#ifdef USE_CUDA
+template <typename PT, std::size_t PD>
+void MiniBatchEuclideanMetric<PT, PD>::fit_gpu()
+{
+    fit_cpu();
+}
+#endif
+
+template <typename PT, std::size_t PD>
+std::vector<Point<PT, PD>> &MiniBatchEuclideanMetric<PT, PD>::getPoints()
+{
+    return this->data;
+}
+
+template <typename PT, std::size_t PD>
+void MiniBatchEuclideanMetric<PT, PD>::assignPoints(PointSet<PT, PD> &points) const
+{
+    const std::vector<CentroidPoint<PT, PD>> &centroids = *this->centroids;
+    const std::size_t numCentroids = centroids.size();
+    const std::size_t numPoints = points.size();
+
+    std::array<const PT *, PD> coordinates;
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coordinates[d] = points.data(d);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (std::size_t i = 0; i < numPoints; ++i)
+    {
+        PT bestDistance = std::numeric_limits<PT>::max();
+        int32_t label = 0;
+        for (std::size_t j = 0; j < numCentroids; ++j)
+        {
+            PT distance = 0;
+            for (std::size_t d = 0; d < PD; ++d)
+            {
+                const PT diff = coordinates[d][i] - centroids[j].coordinates[d];
+                distance += diff * diff;
+            }
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                label = static_cast<int32_t>(j);
+            }
+        }
+        points.setLabel(i, label);
+    }
+}
+
+template <typename PT, std::size_t PD>
+void MiniBatchEuclideanMetric<PT, PD>::storeCentroids() {}
+
+template <typename PT, std::size_t PD>
+std::size_t MiniBatchEuclideanMetric<PT, PD>::nextBatch(PointSet<PT, PD> &batch)
+{
+    if (source)
+    {
+        std::size_t n = source->nextBatch(batchSize, batch);
+        if (n == 0)
+        {
+            source->rewind();
+            n = source->nextBatch(batchSize, batch);
+        }
+        return n;
+    }
+
+    const std::size_t numPoints = this->pointSet.size();
+    if (numPoints == 0)
+    {
+        batch.resize(0);
+        return 0;
+    }
+
+    // Uniform draw with replacement from the points in memory
+    std::uniform_int_distribution<std::size_t> distribution(0, numPoints - 1);
+    batch.resize(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i)
+    {
+        const std::size_t index = distribution(generator);
+        for (std::size_t d = 0; d < PD; ++d)
+        {
+            batch(i, d) = this->pointSet(index, d);
+        }
+    }
+    return batchSize;
+}
+
+// Explicit template instantiations
+template class MiniBatchEuclideanMetric<double, 2>;
+template class MiniBatchEuclideanMetric<double, 3>;
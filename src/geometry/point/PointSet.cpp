@@ -0,0 +1,107 @@
+#include "geometry/point/PointSet.hpp"
+#include <algorithm>
+
+template <typename PT, std::size_t PD>
+PointSet<PT, PD>::PointSet(std::size_t size)
+{
+    resize(size);
+}
+
+template <typename PT, std::size_t PD>
+PointSet<PT, PD>::PointSet(const std::vector<Point<PT, PD>> &points)
+{
+    resize(points.size());
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        for (std::size_t d = 0; d < PD; ++d)
+        {
+            coords[d][i] = points[i].coordinates[d];
+        }
+    }
+}
+
+template <typename PT, std::size_t PD>
+void PointSet<PT, PD>::resize(std::size_t size)
+{
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coords[d].resize(size, PT(0));
+    }
+    labels.resize(size, UNASSIGNED);
+}
+
+template <typename PT, std::size_t PD>
+void PointSet<PT, PD>::reserve(std::size_t size)
+{
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coords[d].reserve(size);
+    }
+    labels.reserve(size);
+}
+
+template <typename PT, std::size_t PD>
+void PointSet<PT, PD>::clear()
+{
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coords[d].clear();
+    }
+    labels.clear();
+}
+
+template <typename PT, std::size_t PD>
+void PointSet<PT, PD>::addPoint(const Point<PT, PD> &point)
+{
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coords[d].push_back(point.coordinates[d]);
+    }
+    labels.push_back(UNASSIGNED);
+}
+
+template <typename PT, std::size_t PD>
+Point<PT, PD> PointSet<PT, PD>::getPoint(std::size_t i) const
+{
+    Point<PT, PD> point;
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        point.coordinates[d] = coords[d][i];
+    }
+    point.setID(static_cast<int>(i));
+    return point;
+}
+
+template <typename PT, std::size_t PD>
+void PointSet<PT, PD>::setPoint(std::size_t i, const Point<PT, PD> &point)
+{
+    for (std::size_t d = 0; d < PD; ++d)
+    {
+        coords[d][i] = point.coordinates[d];
+    }
+}
+
+template <typename PT, std::size_t PD>
+std::vector<Point<PT, PD>> PointSet<PT, PD>::toPoints() const
+{
+    std::vector<Point<PT, PD>> points(size());
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = getPoint(i);
+    }
+    return points;
+}
+
+template <typename PT, std::size_t PD>
+void PointSet<PT, PD>::resetLabels()
+{
+    std::fill(labels.begin(), labels.end(), UNASSIGNED);
+}
+
+// Explicit template instantiation
+template class PointSet<double, 3>;
+template class PointSet<double, 2>;
@@ -48,7 +48,7 @@ int main(int argc, char* argv[]) {
 
         std::vector<Point<double, DIMENSION>> points;
         try {
-            points = CSVUtils::readCSV<double, DIMENSION>(full_path);
+            points = CSVUtils::readPointSetCached<double, DIMENSION>(full_path).toPoints();
         } catch (const std::exception &e) {
             std::cerr << "Failed to read CSV: " << e.what() << '\n';
             std::cerr << "Ensure the file exists at: " << full_path << '\n';
@@ -254,7 +254,7 @@ void Render::start()
 
                 ImGui::Text("Select Metric Method:");
 
-                const Enums::MetricMethod initMetricMethods[] = {Enums::MetricMethod::DIJKSTRA, Enums::MetricMethod::EUCLIDEAN, Enums::MetricMethod::HEAT};
+                const Enums::MetricMethod initMetricMethods[] = {Enums::MetricMethod::DIJKSTRA, Enums::MetricMethod::EUCLIDEAN, Enums::MetricMethod::HEAT, Enums::MetricMethod::VORONOI};
 
                 if (ImGui::BeginCombo("Metric Method", Enums::toString(selectedMetricMethod).c_str()))
                 {
@@ -6,6 +6,7 @@
 #include "geometry/metrics/EuclideanMetric.hpp"
 #include "geometry/metrics/GeodesicDijkstraMetric.hpp"
 #include "geometry/metrics/GeodesicHeatMetric.hpp"
+#include "geometry/metrics/GeodesicVoronoiMetric.hpp"
 #include "clustering/CentroidInitializationMethods/SharedEnum.hpp"
 
 using namespace std;
@@ -22,7 +23,7 @@ int main(int argc, char *argv[])
             std::cerr << "  <mesh_file>       : Name of the mesh file (i.e resources/meshes/obj/1.obj)" << std::endl;
             std::cerr << "  <num_clusters>    : Number of clusters (0 if unknown)" << std::endl;
             std::cerr << "  <init_method>     : Initialization method for centroids (0: random, 1: KDE, 2: most distant, 3: Static KDE - 3D point)" << std::endl;
-            std::cerr << "  <metric>          : Distance metric (0: Euclidean, 1: Dijkstra, 2: Heat)" << std::endl;
+            std::cerr << "  <metric>          : Distance metric (0: Euclidean, 1: Dijkstra, 2: Heat, 3: Voronoi)" << std::endl;
             std::cerr << "  [k_init_method]   : (Optional) Method for k initialization (0: elbow, 1: KDE, 2: Silhouette) if <num_clusters> is 0" << std::endl;
             return 1;
         }
@@ -61,9 +62,14 @@ int main(int argc, char *argv[])
             MeshSegmentation<GeodesicHeatMetric<double, DIM>> segmentation(&mesh, num_clusters, 0.05, num_initialization_method, num_k_init_method);
             segmentation.fit();
         }
+        else if (metric == Enums::MetricMethod::VORONOI)
+        {
+            MeshSegmentation<GeodesicVoronoiMetric<double, DIM>> segmentation(&mesh, num_clusters, 0.05, num_initialization_method, num_k_init_method);
+            segmentation.fit();
+        }
         else
         {
-            std::cerr << "Error: Invalid metric option. Use 0 (Euclidean), 1 (Dijkstra), or 2 (Heat)." << std::endl;
+            std::cerr << "Error: Invalid metric option. Use 0 (Euclidean), 1 (Dijkstra), 2 (Heat) or 3 (Voronoi)." << std::endl;
             return 1;
         }
 
@@ -8,6 +8,7 @@
 #include "geometry/metrics/EuclideanMetric.hpp"
 #include "geometry/metrics/GeodesicDijkstraMetric.hpp"
 #include "geometry/metrics/GeodesicHeatMetric.hpp"
+#include "geometry/metrics/GeodesicVoronoiMetric.hpp"
 #include "SharedEnum.hpp"
 
 #define DIMENSION 2
@@ -51,9 +52,16 @@ std::string segmentationCallback(const std::string &fileName, Enums::CentroidIni
                                                                    static_cast<int>(num_k_init_method));
       segmentation.fit();
     }
+    else if (metric_method == Enums::MetricMethod::VORONOI)
+    {
+      MeshSegmentation<GeodesicVoronoiMetric<double, 3>> segmentation(&mesh, num_clusters, threshold,
+                                                                      static_cast<int>(num_initialization_method),
+                                                                      static_cast<int>(num_k_init_method));
+      segmentation.fit();
+    }
     else
     {
-      std::cerr << "Error: Invalid metric option. Use 0 (Euclidean), 1 (Dijkstra), or 2 (Heat)." << std::endl;
+      std::cerr << "Error: Invalid metric option. Use 0 (Euclidean), 1 (Dijkstra), 2 (Heat) or 3 (Voronoi)." << std::endl;
       return "";
     }
 
@@ -70,3 +70,26 @@ TEST_F(KMeansTest, SetNumClustersWorks)
 
     EXPECT_EQ(kmeans.getCentroids().size(), 2);
 }
+
+// Test that after fitting every point is assigned to its closest centroid
+TEST_F(KMeansTest, AssignmentsPointToClosestCentroid)
+{
+    KMeans<double, 2, Metric2D> kmeans(2, 0.001, metric, 0, 0);
+    kmeans.fit();
+
+    const auto &assignments = kmeans.getAssignments();
+    const auto &centroids = kmeans.getCentroids();
+    const auto &fittedPoints = kmeans.getPoints();
+    ASSERT_EQ(assignments.size(), fittedPoints.size());
+
+    for (std::size_t i = 0; i < fittedPoints.size(); ++i)
+    {
+        ASSERT_GE(assignments[i], 0);
+        ASSERT_LT(assignments[i], static_cast<int32_t>(centroids.size()));
+        double assigned = Metric2D::distanceTo(fittedPoints[i], centroids[assignments[i]]);
+        for (const auto &c : centroids)
+        {
+            EXPECT_LE(assigned, Metric2D::distanceTo(fittedPoints[i], c) + 1e-9);
+        }
+    }
+}
@@ -56,3 +56,158 @@ TEST_F(KdTreeTest, ClearTree)
     tree.~KdTree();
     EXPECT_EQ(tree.getRoot(), nullptr);
 }
+
+// Test that the leaves of a tree built from a point set reference the points by index
+TEST_F(KdTreeTest, PointSetLeafIndices)
+{
+    std::vector<Point<double, 2>> points = {
+        Point<double, 2>({3.0, 1.0}, -1),
+        Point<double, 2>({2.0, 4.0}, -1)};
+    PointSet<double, 2> set(points);
+
+    KdTree<double, 2> tree(set, 1);
+    const KdNode<double, 2> *root = tree.getRoot();
+    ASSERT_NE(root, nullptr);
+    ASSERT_FALSE(root->isLeaf());
+
+    const KdNode<double, 2> &left = tree.getNode(root->left);
+    const KdNode<double, 2> &right = tree.getNode(root->right);
+    EXPECT_EQ(left.count, 1);
+    EXPECT_EQ(right.count, 1);
+
+    const int32_t leftPoint = tree.getIndices()[left.begin];
+    const int32_t rightPoint = tree.getIndices()[right.begin];
+    EXPECT_EQ(leftPoint + rightPoint, 1);
+    EXPECT_EQ(set(leftPoint, 0), left.wgtCent[0]);
+}
+
+// Test that leaf buckets cover every point exactly once and respect the bucket size
+TEST_F(KdTreeTest, BucketedLeaves)
+{
+    std::vector<Point<double, 2>> points;
+    for (int i = 0; i < 100; ++i)
+    {
+        points.push_back(Point<double, 2>({static_cast<double>(i % 10), static_cast<double>(i / 10)}, -1));
+    }
+
+    const std::size_t bucketSize = 8;
+    KdTree<double, 2> tree(points, bucketSize);
+    ASSERT_NE(tree.getRoot(), nullptr);
+    EXPECT_EQ(tree.getRoot()->count, 100);
+
+    std::vector<int> seen(points.size(), 0);
+    for (const auto &node : tree.getNodes())
+    {
+        if (!node.isLeaf())
+        {
+            EXPECT_EQ(node.count, tree.getNode(node.left).count + tree.getNode(node.right).count);
+            continue;
+        }
+        EXPECT_LE(node.count, static_cast<int>(bucketSize));
+        for (int32_t j = node.begin; j < node.end; ++j)
+        {
+            const auto &p = points[tree.getIndices()[j]];
+            EXPECT_EQ(tree.getCoordinates(0)[j], p.coordinates[0]);
+            EXPECT_EQ(tree.getCoordinates(1)[j], p.coordinates[1]);
+            EXPECT_GE(p.coordinates[0], node.cellMin[0]);
+            EXPECT_LE(p.coordinates[0], node.cellMax[0]);
+            seen[tree.getIndices()[j]]++;
+        }
+    }
+
+    for (int count : seen)
+    {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+// Test a tree large enough for the parallel median selection, with many duplicate coordinates
+TEST_F(KdTreeTest, LargeTreeBoundsAndSplits)
+{
+    const std::size_t n = 4 * KdTree<double, 3>::PARALLEL_SELECT_MIN_POINTS + 17;
+    PointSet<double, 3> points(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        points.data(0)[i] = static_cast<double>((i * 7919) % 1000);
+        points.data(1)[i] = static_cast<double>((i * 104729) % 257) * 0.5;
+        points.data(2)[i] = static_cast<double>(i % 3);
+    }
+
+    KdTree<double, 3> tree(points);
+    ASSERT_EQ(tree.getRoot()->count, static_cast<int>(n));
+
+    // Every node holds the exact bounds and sums of its points, split at the median of its axis
+    std::vector<std::pair<int32_t, int>> stack = {{0, 0}};
+    while (!stack.empty())
+    {
+        const auto [index, depth] = stack.back();
+        stack.pop_back();
+        const auto &node = tree.getNode(index);
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            double low = std::numeric_limits<double>::max(), high = std::numeric_limits<double>::lowest(), sum = 0;
+            for (int32_t j = node.begin; j < node.end; ++j)
+            {
+                const double value = points.data(d)[tree.getIndices()[j]];
+                ASSERT_EQ(tree.getCoordinates(d)[j], value);
+                low = std::min(low, value);
+                high = std::max(high, value);
+                sum += value;
+            }
+            ASSERT_EQ(node.cellMin[d], low);
+            ASSERT_EQ(node.cellMax[d], high);
+            ASSERT_NEAR(node.wgtCent[d], sum, 1e-9 * std::max(1.0, sum));
+        }
+        if (node.isLeaf())
+            continue;
+
+        const auto &left = tree.getNode(node.left);
+        const auto &right = tree.getNode(node.right);
+        ASSERT_EQ(left.count, node.count / 2);
+        ASSERT_LE(left.cellMax[depth % 3], right.cellMin[depth % 3]);
+        stack.push_back({node.left, depth + 1});
+        stack.push_back({node.right, depth + 1});
+    }
+
+    std::vector<int32_t> sorted = tree.getIndices();
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        ASSERT_EQ(sorted[i], static_cast<int32_t>(i));
+    }
+}
+
+// Test the nearest neighbour query against a linear scan, ties going to the lowest index
+TEST_F(KdTreeTest, NearestMatchesLinearScan)
+{
+    std::vector<Point<double, 2>> points;
+    for (int i = 0; i < 2000; ++i)
+    {
+        // Every position appears twice, the second copy has the higher index
+        const int j = i % 1000;
+        points.push_back(Point<double, 2>({static_cast<double>((j * 37) % 101), static_cast<double>((j * 53) % 97) * 0.7}, -1));
+    }
+    KdTree<double, 2> tree(points, 4);
+
+    for (int q = 0; q < 500; ++q)
+    {
+        const std::array<double, 2> query = {static_cast<double>((q * 7919) % 1200) * 0.1 - 10, static_cast<double>((q * 104729) % 900) * 0.1 - 10};
+        int32_t expected = -1;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (int32_t i = 0; i < static_cast<int32_t>(points.size()); ++i)
+        {
+            const double dx = points[i].coordinates[0] - query[0];
+            const double dy = points[i].coordinates[1] - query[1];
+            if (dx * dx + dy * dy < bestDistance)
+            {
+                bestDistance = dx * dx + dy * dy;
+                expected = i;
+            }
+        }
+        ASSERT_EQ(tree.nearest(query), expected);
+    }
+
+    std::vector<Point<double, 2>> none;
+    KdTree<double, 2> empty(none);
+    EXPECT_EQ(empty.nearest({0.0, 0.0}), -1);
+}
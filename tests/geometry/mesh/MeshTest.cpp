@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "geometry/mesh/Mesh.hpp"
+#include "geometry/mesh/MeshCache.hpp"
 #include <filesystem>
 #include <fstream>
 
@@ -24,6 +25,16 @@ protected:
         delete mesh;
         std::filesystem::remove(testObjPath);
         std::filesystem::remove(testSegPath);
+        std::filesystem::remove(testObjPath + MeshCache::EXTENSION);
+    }
+
+    // Writes the test mesh dated in the past, so its cache is strictly newer than it
+    void writeOldObj(const std::string &content)
+    {
+        std::ofstream objFile(testObjPath);
+        objFile << content;
+        objFile.close();
+        std::filesystem::last_write_time(testObjPath, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
     }
 };
 
@@ -64,3 +75,109 @@ TEST_F(MeshTest, ExportToGroupedObj)
     EXPECT_TRUE(std::filesystem::exists(outPath));
     std::filesystem::remove(outPath);
 }
+
+TEST_F(MeshTest, FaceAdjacencyIsCompressed)
+{
+    Mesh strip;
+    strip.addVertex(Point<double, 3>({0.0, 0.0, 0.0}));
+    strip.addVertex(Point<double, 3>({1.0, 0.0, 0.0}));
+    strip.addVertex(Point<double, 3>({0.0, 1.0, 0.0}));
+    strip.addVertex(Point<double, 3>({1.0, 1.0, 0.0}));
+    strip.addVertex(Point<double, 3>({5.0, 5.0, 0.0}));
+    strip.addVertex(Point<double, 3>({6.0, 5.0, 0.0}));
+    strip.addVertex(Point<double, 3>({5.0, 6.0, 0.0}));
+    strip.addFace(Face({0, 1, 2}, strip.getVertices(), 0));
+    strip.addFace(Face({1, 3, 2}, strip.getVertices(), 1));
+    strip.addFace(Face({4, 5, 6}, strip.getVertices(), 2));
+
+    strip.buildFaceAdjacency();
+    auto first = strip.getFaceAdjacencyAt(0);
+    auto second = strip.getFaceAdjacencyAt(1);
+    ASSERT_EQ(first.size(), 1);
+    ASSERT_EQ(second.size(), 1);
+    EXPECT_EQ(first[0], 1);
+    EXPECT_EQ(second[0], 0);
+    EXPECT_TRUE(strip.getFaceAdjacencyAt(2).empty());
+
+    strip.buildFaceAdjacencyWeights([](FaceId from, FaceId to)
+                                    { return double(from + 10 * to); });
+    ASSERT_TRUE(strip.hasFaceAdjacencyWeights());
+    EXPECT_EQ(strip.getFaceAdjacencyWeightsAt(0)[0], 10.0);
+    EXPECT_EQ(strip.getFaceAdjacencyWeightsAt(1)[0], 1.0);
+}
+
+TEST_F(MeshTest, FaceClustersAreDense)
+{
+    EXPECT_EQ(mesh->getFaceCluster(0), Mesh::UNASSIGNED_CLUSTER);
+    ASSERT_EQ(mesh->getFaceClusters().size(), 1);
+
+    std::vector<int32_t> labels = {3};
+    mesh->setFaceClusters(labels);
+    EXPECT_EQ(mesh->getFaceCluster(0), 3);
+
+    std::vector<int32_t> wrongSize = {1, 2};
+    EXPECT_THROW(mesh->setFaceClusters(wrongSize), std::invalid_argument);
+
+    mesh->resetFaceClusters();
+    EXPECT_EQ(mesh->getFaceClusters()[0], Mesh::UNASSIGNED_CLUSTER);
+}
+
+TEST_F(MeshTest, ContentHashDependsOnGeometry)
+{
+    Mesh sameMesh(testObjPath);
+    EXPECT_EQ(mesh->contentHash(), sameMesh.contentHash());
+
+    // Clusters are not part of the geometry
+    sameMesh.setFaceCluster(0, 3);
+    EXPECT_EQ(mesh->contentHash(), sameMesh.contentHash());
+
+    sameMesh.addVertex(Point<double, 3>({0.0, 0.0, 1.0}));
+    EXPECT_NE(mesh->contentHash(), sameMesh.contentHash());
+}
+
+TEST_F(MeshTest, CachesMeshNextToSource)
+{
+    const std::string cachePath = testObjPath + MeshCache::EXTENSION;
+    writeOldObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 2 4 3\n");
+    std::filesystem::remove(cachePath);
+
+    Mesh parsed(testObjPath);
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+
+    // Both the automatic cache and the .kmesh file itself give back the parsed mesh
+    for (const std::string &path : {testObjPath, cachePath})
+    {
+        Mesh cached(path);
+        ASSERT_EQ(cached.numFaces(), 2);
+        EXPECT_EQ(cached.contentHash(), parsed.contentHash());
+        for (FaceId f = 0; f < 2; f++)
+        {
+            EXPECT_EQ(cached.getFace(f).vertices, parsed.getFace(f).vertices);
+            EXPECT_DOUBLE_EQ(cached.getFace(f).area, parsed.getFace(f).area);
+            EXPECT_EQ(cached.getFace(f).baricenter.id, static_cast<int>(f));
+            EXPECT_DOUBLE_EQ(cached.getFace(f).normal.coordinates[2], parsed.getFace(f).normal.coordinates[2]);
+            ASSERT_EQ(cached.getFaceAdjacencyAt(f).size(), 1u);
+            EXPECT_EQ(cached.getFaceAdjacencyAt(f)[0], 1 - f);
+        }
+    }
+}
+
+TEST_F(MeshTest, IgnoresStaleOrCorruptedCache)
+{
+    const std::string cachePath = testObjPath + MeshCache::EXTENSION;
+    writeOldObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+    Mesh original(testObjPath);
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+
+    // A changed source is parsed again and its cache rewritten
+    writeOldObj("v 0 0 0\nv 2 0 0\nv 0 2 0\nv 2 2 0\nf 1 2 3\nf 2 4 3\n");
+    Mesh changed(testObjPath);
+    EXPECT_EQ(changed.numFaces(), 2);
+    EXPECT_DOUBLE_EQ(changed.getFace(0).area, 2.0);
+    EXPECT_EQ(Mesh(testObjPath).contentHash(), changed.contentHash());
+
+    // A truncated cache is rejected, and cannot be loaded directly
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 8);
+    EXPECT_THROW(Mesh{cachePath}, std::runtime_error);
+    EXPECT_EQ(Mesh(testObjPath).numFaces(), 2);
+}
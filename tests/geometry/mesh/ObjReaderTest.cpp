@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <filesystem>
+
+#include "geometry/mesh/ObjReader.hpp"
+
+class ObjReaderTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path path;
+
+    void SetUp() override
+    {
+        path = std::filesystem::temp_directory_path() / ("obj_reader_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".obj");
+    }
+
+    void TearDown() override
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    void write(const std::string &content)
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+};
+
+// Test the index formats, negative indices, groups, comments and polygons
+TEST_F(ObjReaderTest, ReadsFacesOfAllGroups)
+{
+    write("# square and triangle\r\n"
+          "mtllib scene.mtl\n"
+          "o square\n"
+          "v 0 0 0\n"
+          "v 1 0 0\n"
+          "v 1 1 0 1.0\n"
+          "v 0 1 0\n"
+          "vt 0 0\nvn 0 0 1\n"
+          "g first\n"
+          "usemtl red\n"
+          "f 1/1/1 2/1/1 3/1/1 4/1/1 # quad\n"
+          "g second\n"
+          "v\t0 0 1\n"
+          "f -5//1 -4//1 -1//1\r\n"
+          "\n");
+
+    Mesh mesh;
+    ObjReader::read(path.string(), mesh);
+
+    ASSERT_EQ(mesh.getMeshVertices().size(), 5u);
+    EXPECT_EQ(mesh.getMeshVertices()[4].coordinates[2], 1.0);
+    EXPECT_EQ(mesh.getMeshVertices()[4].id, 4);
+
+    ASSERT_EQ(mesh.numFaces(), 3);
+    EXPECT_EQ(mesh.getFace(0).vertices, (std::vector<VertId>{0, 1, 2}));
+    EXPECT_EQ(mesh.getFace(1).vertices, (std::vector<VertId>{0, 2, 3}));
+    EXPECT_EQ(mesh.getFace(2).vertices, (std::vector<VertId>{0, 1, 4}));
+    EXPECT_DOUBLE_EQ(mesh.getFace(0).area, 0.5);
+    EXPECT_EQ(mesh.getFace(2).baricenter.id, 2);
+    EXPECT_EQ(mesh.getFaceCluster(2), Mesh::UNASSIGNED_CLUSTER);
+}
+
+// Test that a file larger than a chunk is split at line boundaries
+TEST_F(ObjReaderTest, ReadsLargeFileInChunks)
+{
+    const std::size_t side = 200;
+    std::string content;
+    for (std::size_t y = 0; y <= side; y++)
+    {
+        for (std::size_t x = 0; x <= side; x++)
+        {
+            content += "v " + std::to_string(x) + " " + std::to_string(y) + " 0.5\n";
+        }
+    }
+    for (std::size_t y = 0; y < side; y++)
+    {
+        for (std::size_t x = 0; x < side; x++)
+        {
+            const std::size_t corner = y * (side + 1) + x + 1;
+            content += "f " + std::to_string(corner) + " " + std::to_string(corner + 1) + " " + std::to_string(corner + side + 2) + "\n";
+        }
+    }
+    ASSERT_GT(content.size(), 4 * ObjReader::MIN_CHUNK_BYTES);
+    write(content);
+
+    Mesh mesh;
+    ObjReader::read(path.string(), mesh);
+    ASSERT_EQ(mesh.getMeshVertices().size(), (side + 1) * (side + 1));
+    ASSERT_EQ(mesh.numFaces(), static_cast<int>(side * side));
+    for (std::size_t y = 0; y < side; y++)
+    {
+        for (std::size_t x = 0; x < side; x++)
+        {
+            const Face &face = mesh.getFace(FaceId(y * side + x));
+            const VertId corner = VertId(y * (side + 1) + x);
+            ASSERT_EQ(face.vertices, (std::vector<VertId>{corner, corner + 1, corner + VertId(side) + 2}));
+            ASSERT_DOUBLE_EQ(face.area, 0.5);
+        }
+    }
+}
+
+// Test that malformed vertices and out of range or degenerate faces are rejected
+TEST_F(ObjReaderTest, RejectsInvalidContent)
+{
+    Mesh mesh;
+    for (const char *content : {"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n",
+                                "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 -4\n",
+                                "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n",
+                                "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\nf 1 2 3\n",
+                                "v 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n",
+                                "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 a\n",
+                                "v 0 0 0\nv 1 0 0\nv 0 1 0\n"})
+    {
+        write(content);
+        EXPECT_THROW(ObjReader::read(path.string(), mesh), std::runtime_error) << content;
+    }
+    EXPECT_THROW(ObjReader::read(path.string() + ".missing", mesh), std::runtime_error);
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "geometry/metrics/DistanceArena.hpp"
+
+// Test that every row starts on a cache line and that the rows do not overlap
+TEST(DistanceArenaTest, AlignsEveryRow)
+{
+    DistanceArena<float> arena;
+    EXPECT_FALSE(arena.resize(3, 21));
+    EXPECT_EQ(arena.rows(), 3u);
+    EXPECT_EQ(arena.columns(), 21u);
+    EXPECT_EQ(arena.stride(), 32u);
+
+    for (std::size_t row = 0; row < arena.rows(); ++row)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(arena.row(row)) % DistanceArena<float>::ALIGNMENT, 0u);
+        for (std::size_t column = 0; column < arena.columns(); ++column)
+        {
+            arena.row(row)[column] = static_cast<float>(row * 100 + column);
+        }
+    }
+    for (std::size_t row = 0; row < arena.rows(); ++row)
+    {
+        EXPECT_EQ(arena.row(row)[arena.columns() - 1], static_cast<float>(row * 100 + arena.columns() - 1));
+    }
+}
+
+// Test that the rows are kept with the same shape and the buffer is only grown when needed
+TEST(DistanceArenaTest, KeepsRowsOfSameShape)
+{
+    DistanceArena<double> arena;
+    arena.resize(4, 100);
+    arena.row(2)[50] = 1.5;
+    const double *buffer = arena.row(0);
+
+    EXPECT_TRUE(arena.resize(4, 100));
+    EXPECT_EQ(arena.row(2)[50], 1.5);
+
+    // A smaller shape reuses the buffer, a larger one reallocates it
+    EXPECT_FALSE(arena.resize(2, 100));
+    EXPECT_EQ(arena.row(0), buffer);
+    EXPECT_FALSE(arena.resize(8, 100));
+    EXPECT_GE(arena.capacityBytes(), 8 * arena.stride() * sizeof(double));
+
+    arena.release();
+    EXPECT_EQ(arena.rows(), 0u);
+    EXPECT_EQ(arena.capacityBytes(), 0u);
+}
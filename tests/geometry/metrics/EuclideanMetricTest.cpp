@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <random>
+
 #include "geometry/metrics/EuclideanMetric.hpp"
 
 // Define a simple test fixture
@@ -38,3 +40,115 @@ TEST_F(EuclideanMetricTest, DistanceToCalculatesCorrectly)
     Point2D b({3.0, 4.0}, -1);
     EXPECT_DOUBLE_EQ(metric->distanceTo(a, b), 5.0);
 }
+
+// Test squared Euclidean distance calculation in 2D and 3D
+TEST_F(EuclideanMetricTest, SquaredDistanceCalculatesCorrectly)
+{
+    Point2D a({0.0, 0.0}, -1);
+    Point2D b({3.0, 4.0}, -1);
+    EXPECT_DOUBLE_EQ(metric->squaredDistance(a, b), 25.0);
+
+    Point<double, 3> c({1.0, 2.0, 3.0}, -1);
+    Point<double, 3> d({2.0, 4.0, 6.0}, -1);
+    using Metric3D = EuclideanMetric<double, 3>;
+    EXPECT_DOUBLE_EQ(Metric3D::squaredDistance(c, d), 14.0);
+}
+
+// Test that the bounded engines reach the same clustering as the kd-tree filter
+TEST_F(EuclideanMetricTest, BoundedEnginesMatchKdTreeFilter)
+{
+    using Engine = EuclideanMetric<double, 2>::Engine;
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<Point2D> points;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const double cx = 10.0 * (i % 6);
+        const double cy = 7.0 * ((i / 6) % 4);
+        points.push_back(Point2D({cx + noise(generator), cy + noise(generator)}, -1));
+    }
+
+    auto fit = [&](Engine engine, std::vector<CentroidPoint<double, 2>> &centroids)
+    {
+        EuclideanMetric<double, 2> engineMetric(points, 1e-6, engine);
+        for (int j = 0; j < 10; ++j)
+        {
+            centroids.push_back(CentroidPoint<double, 2>(points[j * 97]));
+        }
+        engineMetric.setCentroids(centroids);
+        engineMetric.fit_cpu();
+        return engineMetric.getAssignments();
+    };
+
+    std::vector<CentroidPoint<double, 2>> kdCentroids, hamerlyCentroids, elkanCentroids;
+    const std::vector<int32_t> kdLabels = fit(Engine::KDTREE_FILTER, kdCentroids);
+    EXPECT_EQ(fit(Engine::HAMERLY, hamerlyCentroids), kdLabels);
+    EXPECT_EQ(fit(Engine::ELKAN, elkanCentroids), kdLabels);
+    for (size_t j = 0; j < kdCentroids.size(); ++j)
+    {
+        for (size_t d = 0; d < 2; ++d)
+        {
+            EXPECT_NEAR(hamerlyCentroids[j].coordinates[d], kdCentroids[j].coordinates[d], 1e-9);
+            EXPECT_NEAR(elkanCentroids[j].coordinates[d], kdCentroids[j].coordinates[d], 1e-9);
+        }
+    }
+}
+
+// Test that the task-parallel kd-tree filtering does not depend on the number of threads,
+// with candidate sets stored as bit masks (up to 64 clusters) and as lists
+TEST_F(EuclideanMetricTest, KdTreeFilterMatchesAcrossThreadCounts)
+{
+    using Engine = EuclideanMetric<double, 2>::Engine;
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> uniform(0.0, 100.0);
+    std::vector<Point2D> points;
+    for (int i = 0; i < 20000; ++i)
+    {
+        points.push_back(Point2D({uniform(generator), uniform(generator)}, -1));
+    }
+
+    auto fit = [&](Engine engine, int numThreads, int numClusters, std::vector<CentroidPoint<double, 2>> &centroids)
+    {
+        const int previousThreads = omp_get_max_threads();
+        omp_set_num_threads(numThreads);
+        EuclideanMetric<double, 2> threadMetric(points, 1e-6, engine);
+        for (int j = 0; j < numClusters; ++j)
+        {
+            centroids.push_back(CentroidPoint<double, 2>(points[j * 211]));
+        }
+        threadMetric.setCentroids(centroids);
+        threadMetric.fit_cpu();
+        omp_set_num_threads(previousThreads);
+        return threadMetric.getAssignments();
+    };
+
+    for (int numClusters : {12, 80})
+    {
+        std::vector<CentroidPoint<double, 2>> serialCentroids, parallelCentroids, hamerlyCentroids;
+        const std::vector<int32_t> serialLabels = fit(Engine::KDTREE_FILTER, 1, numClusters, serialCentroids);
+        EXPECT_EQ(fit(Engine::KDTREE_FILTER, 8, numClusters, parallelCentroids), serialLabels) << numClusters;
+        EXPECT_EQ(fit(Engine::HAMERLY, 1, numClusters, hamerlyCentroids), serialLabels) << numClusters;
+        for (size_t j = 0; j < serialCentroids.size(); ++j)
+        {
+            EXPECT_EQ(parallelCentroids[j].count, serialCentroids[j].count);
+            for (size_t d = 0; d < 2; ++d)
+            {
+                EXPECT_NEAR(parallelCentroids[j].coordinates[d], serialCentroids[j].coordinates[d], 1e-9);
+            }
+        }
+    }
+}
+
+// Test the automatic choice of the engine
+TEST_F(EuclideanMetricTest, SelectsEngine)
+{
+    using Metric2D = EuclideanMetric<double, 2>;
+    using Metric32D = EuclideanMetric<double, 32>;
+    EXPECT_EQ(metric->getEngine(), Metric2D::Engine::AUTO);
+    EXPECT_EQ(Metric2D::selectEngine(100000, 8), Metric2D::Engine::KDTREE_FILTER);
+    EXPECT_EQ(Metric2D::selectEngine(5000, 512), Metric2D::Engine::HAMERLY);
+    EXPECT_EQ(Metric32D::selectEngine(100000, 64), Metric32D::Engine::ELKAN);
+    EXPECT_EQ(Metric32D::selectEngine(std::size_t(1) << 24, 64), Metric32D::Engine::HAMERLY);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <omp.h>
+#include "clustering/KMeans.hpp"
+#include "geometry/metrics/GeodesicDijkstraMetric.hpp"
+#include "geometry/mesh/Mesh.hpp"
+
+// Exposes the distance computations of the metric to the tests
+class TestableDijkstraMetric : public GeodesicDijkstraMetric<double, 3>
+{
+public:
+    using GeodesicDijkstraMetric<double, 3>::GeodesicDijkstraMetric;
+    using GeodesicDijkstraMetric<double, 3>::setupAdjacency;
+    using GeodesicDijkstraMetric<double, 3>::computeDistances;
+    using GeodesicDijkstraMetric<double, 3>::computeDistancesDeltaStepping;
+    using GeodesicDijkstraMetric<double, 3>::useParallelSearch;
+    using GeodesicDijkstraMetric<double, 3>::useBounds;
+};
+
+class GeodesicDijkstraMetricTest : public ::testing::Test
+{
+protected:
+    static constexpr int GRID_SIZE = 20;
+    Mesh mesh;
+
+    void SetUp() override
+    {
+        // Create a curved grid of GRID_SIZE x GRID_SIZE quads, two triangles each
+        for (int y = 0; y <= GRID_SIZE; ++y)
+        {
+            for (int x = 0; x <= GRID_SIZE; ++x)
+            {
+                mesh.addVertex(Point<double, 3>({double(x), double(y), std::sin(0.5 * x) * std::cos(0.3 * y)}));
+            }
+        }
+        auto vertex = [](int x, int y) { return VertId(y * (GRID_SIZE + 1) + x); };
+        for (int y = 0; y < GRID_SIZE; ++y)
+        {
+            for (int x = 0; x < GRID_SIZE; ++x)
+            {
+                mesh.addFace(Face({vertex(x, y), vertex(x + 1, y), vertex(x, y + 1)}, mesh.getVertices(), mesh.numFaces()));
+                mesh.addFace(Face({vertex(x + 1, y), vertex(x + 1, y + 1), vertex(x, y + 1)}, mesh.getVertices(), mesh.numFaces()));
+            }
+        }
+    }
+};
+
+// Test that delta-stepping computes the same distance field as Dijkstra
+TEST_F(GeodesicDijkstraMetricTest, DeltaSteppingMatchesDijkstra)
+{
+    TestableDijkstraMetric metric(mesh, 0.05, mesh.getMeshFacesPoints());
+    metric.setupAdjacency();
+
+    for (FaceId startFace : {FaceId(0), FaceId(mesh.numFaces() / 2), FaceId(mesh.numFaces() - 1)})
+    {
+        std::vector<double> expected = metric.computeDistances(startFace);
+        std::vector<double> distances = metric.computeDistancesDeltaStepping(startFace);
+
+        ASSERT_EQ(distances.size(), expected.size());
+        EXPECT_EQ(distances[startFace], 0.0);
+        for (size_t faceId = 0; faceId < expected.size(); ++faceId)
+        {
+            EXPECT_DOUBLE_EQ(distances[faceId], expected[faceId]);
+        }
+    }
+}
+
+// Test that delta-stepping is only selected automatically with fewer centroids than threads
+TEST_F(GeodesicDijkstraMetricTest, SelectsSearchEngine)
+{
+    const int numThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+
+    std::vector<CentroidPoint<double, 3>> centroids(2);
+    TestableDijkstraMetric metric(mesh, 0.05, mesh.getMeshFacesPoints());
+    metric.setCentroids(centroids);
+    EXPECT_TRUE(metric.useParallelSearch());
+
+    centroids.resize(8);
+    EXPECT_FALSE(metric.useParallelSearch());
+
+    metric.setSearchEngine(GeodesicDijkstraMetric<double, 3>::SearchEngine::DELTA_STEPPING);
+    EXPECT_TRUE(metric.useParallelSearch());
+
+    omp_set_num_threads(numThreads);
+}
+
+// Test that the bounds skip faces without changing the segmentation
+TEST_F(GeodesicDijkstraMetricTest, BoundsKeepAssignments)
+{
+    const int numClusters = 5;
+    const int mostDistantInit = 2;
+
+    TestableDijkstraMetric exact(mesh, 0.01, mesh.getMeshFacesPoints());
+    exact.useBounds = false;
+    KMeans<double, 3, GeodesicDijkstraMetric<double, 3>> exactKMeans(numClusters, 0.01, &exact, mostDistantInit, 0);
+    exactKMeans.fit();
+    std::vector<int32_t> expected(mesh.getFaceClusters().begin(), mesh.getFaceClusters().end());
+
+    mesh.resetFaceClusters();
+    TestableDijkstraMetric bounded(mesh, 0.01, mesh.getMeshFacesPoints());
+    KMeans<double, 3, GeodesicDijkstraMetric<double, 3>> boundedKMeans(numClusters, 0.01, &bounded, mostDistantInit, 0);
+    boundedKMeans.fit();
+
+    for (FaceId faceId = 0; faceId < mesh.numFaces(); ++faceId)
+    {
+        EXPECT_EQ(mesh.getFaceCluster(faceId), expected[faceId]);
+    }
+
+    size_t skipped = 0;
+    ASSERT_FALSE(bounded.getAssignmentStats().empty());
+    EXPECT_EQ(bounded.getAssignmentStats().front().fullScans, mesh.numFaces());
+    for (const auto &stats : bounded.getAssignmentStats())
+    {
+        EXPECT_EQ(stats.skippedByBounds + stats.skippedAfterTightening + stats.fullScans, stats.numFaces);
+        skipped += stats.skippedByBounds + stats.skippedAfterTightening;
+    }
+    EXPECT_GT(skipped, 0);
+}
+
+// Test that single precision fields give the same segmentation
+TEST_F(GeodesicDijkstraMetricTest, FloatDistancesKeepAssignments)
+{
+    const int numClusters = 5;
+    const int mostDistantInit = 2;
+
+    TestableDijkstraMetric doubles(mesh, 0.01, mesh.getMeshFacesPoints());
+    KMeans<double, 3, GeodesicDijkstraMetric<double, 3>> doubleKMeans(numClusters, 0.01, &doubles, mostDistantInit, 0);
+    doubleKMeans.fit();
+    std::vector<int32_t> expected(mesh.getFaceClusters().begin(), mesh.getFaceClusters().end());
+
+    mesh.resetFaceClusters();
+    TestableDijkstraMetric floats(mesh, 0.01, mesh.getMeshFacesPoints());
+    floats.setFloatDistances(true);
+    EXPECT_TRUE(floats.useFloatDistances());
+    KMeans<double, 3, GeodesicDijkstraMetric<double, 3>> floatKMeans(numClusters, 0.01, &floats, mostDistantInit, 0);
+    floatKMeans.fit();
+
+    for (FaceId faceId = 0; faceId < mesh.numFaces(); ++faceId)
+    {
+        EXPECT_EQ(mesh.getFaceCluster(faceId), expected[faceId]);
+    }
+    EXPECT_EQ(floats.getAssignmentStats().size(), doubles.getAssignmentStats().size());
+}
+
+// Test that the snapping of the centroids through the face index matches a linear scan
+TEST_F(GeodesicDijkstraMetricTest, FindsClosestFaceWithIndex)
+{
+    TestableDijkstraMetric metric(mesh, 0.05, mesh.getMeshFacesPoints());
+    auto index = metric.getFaceIndex();
+    ASSERT_EQ(index->getIndices().size(), static_cast<size_t>(mesh.numFaces()));
+    EXPECT_EQ(metric.getFaceIndex(), index);
+
+    for (int q = 0; q < 100; ++q)
+    {
+        const Point<double, 3> centroid({0.23 * q - 1.0, 0.17 * ((q * 7) % 100), 0.5 * std::sin(0.1 * q)});
+        FaceId expected = 0;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (FaceId faceId = 0; faceId < mesh.numFaces(); ++faceId)
+        {
+            double distance = 0;
+            for (std::size_t d = 0; d < 3; ++d)
+            {
+                const double diff = mesh.getFace(faceId).baricenter.coordinates[d] - centroid.coordinates[d];
+                distance += diff * diff;
+            }
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                expected = faceId;
+            }
+        }
+        ASSERT_EQ(metric.findClosestFace(centroid), expected);
+    }
+}
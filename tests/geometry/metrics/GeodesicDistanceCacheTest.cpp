@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "geometry/metrics/GeodesicDistanceCache.hpp"
+
+// Test fixture for GeodesicDistanceCache
+class GeodesicDistanceCacheTest : public ::testing::Test
+{
+protected:
+    // Budget of exactly two fields of four distances
+    GeodesicDistanceCache<double> cache{2 * 4 * sizeof(double)};
+    int computations = 0;
+
+    std::vector<double> field(FaceId seed)
+    {
+        computations++;
+        return std::vector<double>(4, static_cast<double>(seed));
+    }
+};
+
+// Test that a second lookup of the same seed is served by the cache
+TEST_F(GeodesicDistanceCacheTest, ReusesComputedFields)
+{
+    auto compute = [this](FaceId seed) { return field(seed); };
+    auto first = cache.getOrCompute(3, compute);
+    auto second = cache.getOrCompute(3, compute);
+
+    EXPECT_EQ(computations, 1);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ((*second)[0], 3.0);
+    EXPECT_EQ(cache.getHits(), 1);
+    EXPECT_EQ(cache.getMisses(), 1);
+}
+
+// Test that the least recently used field is evicted when the budget is exceeded
+TEST_F(GeodesicDistanceCacheTest, EvictsLeastRecentlyUsed)
+{
+    auto compute = [this](FaceId seed) { return field(seed); };
+    cache.getOrCompute(0, compute);
+    cache.getOrCompute(1, compute);
+    cache.getOrCompute(0, compute); // 1 becomes the least recently used
+    auto held = cache.getOrCompute(2, compute);
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.getMemoryUsage(), 2 * 4 * sizeof(double));
+    EXPECT_NE(cache.get(0), nullptr);
+    EXPECT_EQ(cache.get(1), nullptr);
+    EXPECT_NE(cache.get(2), nullptr);
+
+    // An evicted field stays valid for its holders
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ((*held)[3], 2.0);
+}
+
+// Test that shrinking the budget evicts fields
+TEST_F(GeodesicDistanceCacheTest, ShrinkingBudgetEvicts)
+{
+    cache.put(0, std::vector<double>(4, 0.0));
+    cache.put(1, std::vector<double>(4, 1.0));
+    cache.setMemoryBudget(4 * sizeof(double));
+
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_NE(cache.get(1), nullptr);
+}
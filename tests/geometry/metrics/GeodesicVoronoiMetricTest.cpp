@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "clustering/KMeans.hpp"
+#include "geometry/metrics/GeodesicVoronoiMetric.hpp"
+#include "geometry/mesh/Mesh.hpp"
+
+class GeodesicVoronoiMetricTest : public ::testing::Test
+{
+protected:
+    static constexpr int GRID_SIZE = 12;
+    Mesh mesh;
+
+    void SetUp() override
+    {
+        // Create a slightly curved grid of GRID_SIZE x GRID_SIZE quads, two triangles each
+        for (int y = 0; y <= GRID_SIZE; ++y)
+        {
+            for (int x = 0; x <= GRID_SIZE; ++x)
+            {
+                mesh.addVertex(Point<double, 3>({double(x), double(y), 0.1 * std::sin(0.3 * x)}));
+            }
+        }
+        auto vertex = [](int x, int y) { return VertId(y * (GRID_SIZE + 1) + x); };
+        for (int y = 0; y < GRID_SIZE; ++y)
+        {
+            for (int x = 0; x < GRID_SIZE; ++x)
+            {
+                mesh.addFace(Face({vertex(x, y), vertex(x + 1, y), vertex(x, y + 1)}, mesh.getVertices(), mesh.numFaces()));
+                mesh.addFace(Face({vertex(x + 1, y), vertex(x + 1, y + 1), vertex(x, y + 1)}, mesh.getVertices(), mesh.numFaces()));
+            }
+        }
+    }
+};
+
+// Test that every face gets the cluster of the seed in its corner of the grid
+TEST_F(GeodesicVoronoiMetricTest, AssignsFacesToClosestSeed)
+{
+    std::vector<CentroidPoint<double, 3>> centroids;
+    centroids.emplace_back(Point<double, 3>({0.0, 0.0, 0.0}));
+    centroids.emplace_back(Point<double, 3>({double(GRID_SIZE), double(GRID_SIZE), 0.0}));
+
+    GeodesicVoronoiMetric<double, 3> metric(mesh, 0.01, mesh.getMeshFacesPoints());
+    metric.setCentroids(centroids);
+    metric.fit_cpu();
+
+    const FaceId firstCorner = 0;
+    const FaceId lastCorner = mesh.numFaces() - 1;
+    EXPECT_NE(mesh.getFaceCluster(firstCorner), mesh.getFaceCluster(lastCorner));
+    for (FaceId faceId = 0; faceId < mesh.numFaces(); ++faceId)
+    {
+        ASSERT_GE(mesh.getFaceCluster(faceId), 0);
+        ASSERT_LT(mesh.getFaceCluster(faceId), 2);
+    }
+}
+
+// Test that the multi-source search gives the same segmentation as one search per centroid
+TEST_F(GeodesicVoronoiMetricTest, MatchesDijkstraMetric)
+{
+    const int numClusters = 4;
+    const int mostDistantInit = 2;
+
+    GeodesicDijkstraMetric<double, 3> dijkstra(mesh, 0.01, mesh.getMeshFacesPoints());
+    KMeans<double, 3, GeodesicDijkstraMetric<double, 3>> dijkstraKMeans(numClusters, 0.01, &dijkstra, mostDistantInit, 0);
+    dijkstraKMeans.fit();
+    std::vector<int32_t> expected(mesh.getFaceClusters().begin(), mesh.getFaceClusters().end());
+
+    mesh.resetFaceClusters();
+    GeodesicVoronoiMetric<double, 3> voronoi(mesh, 0.01, mesh.getMeshFacesPoints());
+    KMeans<double, 3, GeodesicVoronoiMetric<double, 3>> voronoiKMeans(numClusters, 0.01, &voronoi, mostDistantInit, 0);
+    voronoiKMeans.fit();
+
+    for (FaceId faceId = 0; faceId < mesh.numFaces(); ++faceId)
+    {
+        EXPECT_EQ(mesh.getFaceCluster(faceId), expected[faceId]);
+    }
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "geometry/metrics/HeatPrecomputeCache.hpp"
+
+using HeatCache = HeatPrecomputeCache<double>;
+
+// Test fixture for HeatPrecomputeCache
+class HeatPrecomputeCacheTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory = "heat_cache_test";
+    int assemblies = 0;
+
+    // Operators of a 3-vertex system, simple enough for any factorization
+    HeatCache::Operators assemble()
+    {
+        assemblies++;
+        HeatCache::Operators operators;
+        Eigen::SparseMatrix<double> identity(3, 3);
+        identity.setIdentity();
+        operators.Grad = identity;
+        operators.Div = 2.0 * identity;
+        operators.Q = identity;
+        operators.Poisson = identity;
+        operators.Aeq = Eigen::RowVectorXd::Ones(3).sparseView();
+        operators.b = Eigen::VectorXi::LinSpaced(2, 0, 1);
+        operators.ng = 3;
+        return operators;
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+// Test that a second lookup of the same mesh reuses the factorized data
+TEST_F(HeatPrecomputeCacheTest, ReusesDataInMemory)
+{
+    HeatCache cache;
+    auto first = cache.getOrCompute(42, [this]() { return assemble(); });
+    auto second = cache.getOrCompute(42, [this]() { return assemble(); });
+
+    EXPECT_EQ(assemblies, 1);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(second->ng, 3);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+// Test that the oldest mesh is evicted once the capacity is exceeded
+TEST_F(HeatPrecomputeCacheTest, EvictsOldestMesh)
+{
+    HeatCache cache(2);
+    cache.getOrCompute(1, [this]() { return assemble(); });
+    cache.getOrCompute(2, [this]() { return assemble(); });
+    cache.getOrCompute(3, [this]() { return assemble(); });
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.get(1), nullptr);
+    EXPECT_NE(cache.get(3), nullptr);
+}
+
+// Test that a new cache on the same directory reads the operators from disk
+TEST_F(HeatPrecomputeCacheTest, LoadsOperatorsFromDisk)
+{
+    HeatCache writer;
+    writer.setDirectory(directory);
+    writer.getOrCompute(7, [this]() { return assemble(); });
+    ASSERT_EQ(assemblies, 1);
+
+    HeatCache reader;
+    reader.setDirectory(directory);
+    auto data = reader.getOrCompute(7, [this]() { return assemble(); });
+
+    EXPECT_EQ(assemblies, 1);
+    EXPECT_EQ(data->ng, 3);
+    EXPECT_DOUBLE_EQ(data->Div.coeff(1, 1), 2.0);
+    EXPECT_EQ(data->b.size(), 2);
+}
+
+// Test that the operator files round-trip and are rejected for another mesh
+TEST_F(HeatPrecomputeCacheTest, ValidatesOperatorFiles)
+{
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path path = directory / "operators.heat";
+    ASSERT_TRUE(HeatCache::saveOperators(path, 5, assemble()));
+
+    HeatCache::Operators operators;
+    ASSERT_TRUE(HeatCache::loadOperators(path, 5, operators));
+    EXPECT_EQ(operators.Q.nonZeros(), 3);
+    EXPECT_DOUBLE_EQ(operators.Aeq.coeff(0, 2), 1.0);
+
+    EXPECT_FALSE(HeatCache::loadOperators(path, 6, operators));
+    EXPECT_FALSE(HeatCache::loadOperators(directory / "missing.heat", 5, operators));
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "geometry/metrics/MiniBatchEuclideanMetric.hpp"
+
+// Source reading blobs of points in chunks, in the order they were generated
+class ChunkedBlobSource : public BatchSource<double, 2>
+{
+public:
+    explicit ChunkedBlobSource(const std::vector<Point<double, 2>> &points) : points(points) {}
+
+    std::size_t nextBatch(std::size_t batchSize, PointSet<double, 2> &batch) override
+    {
+        const std::size_t n = std::min(batchSize, points.size() - position);
+        batch.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            batch.setPoint(i, points[position + i]);
+        }
+        position += n;
+        return n;
+    }
+
+    void rewind() override
+    {
+        position = 0;
+        rewinds++;
+    }
+
+    std::vector<Point<double, 2>> points;
+    std::size_t position = 0;
+    std::size_t rewinds = 0;
+};
+
+class MiniBatchEuclideanMetricTest : public ::testing::Test
+{
+protected:
+    using Point2D = Point<double, 2>;
+    using Metric2D = MiniBatchEuclideanMetric<double, 2>;
+    std::vector<std::array<double, 2>> centers = {{{0.0, 0.0}}, {{20.0, 0.0}}, {{0.0, 20.0}}, {{20.0, 20.0}}};
+    std::vector<Point2D> points;
+    std::vector<CentroidPoint<double, 2>> centroids;
+
+    void SetUp() override
+    {
+        // Interleaved blobs, so every chunk of the source covers all of them
+        std::mt19937 generator(7);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        for (int i = 0; i < 8000; ++i)
+        {
+            const std::array<double, 2> &center = centers[i % centers.size()];
+            points.push_back(Point2D({center[0] + noise(generator), center[1] + noise(generator)}, -1));
+        }
+        for (std::size_t j = 0; j < centers.size(); ++j)
+        {
+            centroids.push_back(CentroidPoint<double, 2>(points[j + 4 * centers.size()]));
+        }
+    }
+
+    void expectCentroidsAtCenters(double tolerance)
+    {
+        for (std::size_t j = 0; j < centers.size(); ++j)
+        {
+            EXPECT_NEAR(centroids[j].coordinates[0], centers[j][0], tolerance);
+            EXPECT_NEAR(centroids[j].coordinates[1], centers[j][1], tolerance);
+        }
+    }
+};
+
+// Test that random batches drawn from memory find the blobs and label every point
+TEST_F(MiniBatchEuclideanMetricTest, FitsPointsInMemory)
+{
+    Metric2D metric(points, 256, 1e-3);
+    metric.setCentroids(centroids);
+    metric.fit_cpu();
+
+    expectCentroidsAtCenters(0.2);
+    EXPECT_GT(metric.getIterations(), 1u);
+    EXPECT_LT(metric.getIterations(), Metric2D::DEFAULT_MAX_ITERATIONS);
+
+    const std::vector<int32_t> &labels = metric.getAssignments();
+    ASSERT_EQ(labels.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_EQ(labels[i], static_cast<int32_t>(i % centers.size()));
+    }
+}
+
+// Test that a chunked source is rewound at the end of a pass and only its sample is kept
+TEST_F(MiniBatchEuclideanMetricTest, FitsChunkedSource)
+{
+    auto source = std::make_shared<ChunkedBlobSource>(points);
+    Metric2D metric(source, 500, 1e-4, 100);
+    EXPECT_EQ(metric.getPoints().size(), 100u);
+
+    metric.setCentroids(centroids);
+    metric.fit_cpu();
+
+    expectCentroidsAtCenters(0.2);
+    EXPECT_GT(source->rewinds, 1u);
+    EXPECT_EQ(metric.getAssignments().size(), 100u);
+
+    PointSet<double, 2> chunk(std::vector<Point2D>(points.begin(), points.begin() + 8));
+    metric.assignPoints(chunk);
+    for (std::size_t i = 0; i < chunk.size(); ++i)
+    {
+        EXPECT_EQ(chunk.getLabel(i), static_cast<int32_t>(i % centers.size()));
+    }
+}
+
+// Test that the learning rate schedule drives the updates
+TEST_F(MiniBatchEuclideanMetricTest, UsesLearningRate)
+{
+    // A negative threshold never stops on the drift
+    Metric2D metric(points, 256, -1.0);
+    metric.setCentroids(centroids);
+    metric.setMaxIterations(5);
+
+    std::size_t calls = 0;
+    metric.setLearningRate([&](std::size_t, std::size_t, std::size_t)
+                           { calls++; return 0.0; });
+    const std::vector<CentroidPoint<double, 2>> initial = centroids;
+    metric.fit_cpu();
+
+    EXPECT_EQ(calls, 5 * centers.size());
+    for (std::size_t j = 0; j < centers.size(); ++j)
+    {
+        EXPECT_EQ(centroids[j].coordinates, initial[j].coordinates);
+    }
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "geometry/point/PointSet.hpp"
+#include <vector>
+
+constexpr int32_t UNASSIGNED = PointSet<double, 3>::UNASSIGNED;
+
+// Test fixture for PointSet
+class PointSetTest : public ::testing::Test
+{
+protected:
+    std::vector<Point<double, 3>> points = {
+        Point<double, 3>({1.0, 2.0, 3.0}, -1),
+        Point<double, 3>({4.0, 5.0, 6.0}, -1),
+        Point<double, 3>({7.0, 8.0, 9.0}, -1)};
+};
+
+// Test that an empty set has no points
+TEST_F(PointSetTest, EmptySet)
+{
+    PointSet<double, 3> set;
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(set.size(), 0);
+}
+
+// Test that the coordinates are stored contiguously per dimension
+TEST_F(PointSetTest, ConstructFromPoints)
+{
+    PointSet<double, 3> set(points);
+    ASSERT_EQ(set.size(), 3);
+
+    const double *x = set.data(0);
+    const double *z = set.data(2);
+    EXPECT_EQ(x[0], 1.0);
+    EXPECT_EQ(x[1], 4.0);
+    EXPECT_EQ(x[2], 7.0);
+    EXPECT_EQ(z[2], 9.0);
+    EXPECT_EQ(set(1, 1), 5.0);
+
+    for (std::size_t i = 0; i < set.size(); ++i)
+    {
+        EXPECT_EQ(set.getLabel(i), UNASSIGNED);
+    }
+}
+
+// Test the conversion back to a vector of points
+TEST_F(PointSetTest, ToPoints)
+{
+    PointSet<double, 3> set(points);
+    std::vector<Point<double, 3>> converted = set.toPoints();
+    ASSERT_EQ(converted.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_EQ(converted[i].id, static_cast<int>(i));
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            EXPECT_EQ(converted[i].coordinates[d], points[i].coordinates[d]);
+        }
+    }
+}
+
+// Test setting and resetting the labels
+TEST_F(PointSetTest, Labels)
+{
+    PointSet<double, 3> set(points);
+    set.setLabel(0, 2);
+    set.setLabel(2, 1);
+    EXPECT_EQ(set.getLabel(0), 2);
+    EXPECT_EQ(set.getLabel(1), UNASSIGNED);
+    EXPECT_EQ(set.getLabels()[2], 1);
+
+    set.resetLabels();
+    EXPECT_EQ(set.getLabel(0), UNASSIGNED);
+    EXPECT_EQ(set.getLabel(2), UNASSIGNED);
+}
+
+// Test appending points
+TEST_F(PointSetTest, AddPoint)
+{
+    PointSet<double, 3> set;
+    set.addPoint(points[1]);
+    ASSERT_EQ(set.size(), 1);
+    EXPECT_EQ(set(0, 0), 4.0);
+    EXPECT_EQ(set.getLabel(0), UNASSIGNED);
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <filesystem>
+
+#include "utils/CSVUtils.hpp"
+
+class CSVUtilsTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path path;
+
+    void SetUp() override
+    {
+        path = std::filesystem::temp_directory_path() / ("csv_utils_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".csv");
+    }
+
+    void TearDown() override
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(BinaryCache::cachePath(path, PointSetCache::EXTENSION), error);
+    }
+
+    void write(const std::string &content)
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+};
+
+// Test that the header, the byte order mark, blank lines and CRLF endings are handled
+TEST_F(CSVUtilsTest, ReadsPointSetWithHeader)
+{
+    write("\xEF\xBB\xBFx,y,z\r\n1,2,3\r\n\r\n-4.5, 6e2 ,.25\r\n7,8,9");
+    using PointSet3D = PointSet<double, 3>;
+    PointSet3D points = CSVUtils::readPointSet<double, 3>(path.string());
+
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_DOUBLE_EQ(points(0, 0), 1.0);
+    EXPECT_DOUBLE_EQ(points(1, 0), -4.5);
+    EXPECT_DOUBLE_EQ(points(1, 1), 600.0);
+    EXPECT_DOUBLE_EQ(points(1, 2), 0.25);
+    EXPECT_DOUBLE_EQ(points(2, 2), 9.0);
+    EXPECT_EQ(points.getLabel(0), PointSet3D::UNASSIGNED);
+
+    std::vector<Point<double, 3>> vector = CSVUtils::readCSV<double, 3>(path.string());
+    ASSERT_EQ(vector.size(), 3u);
+    EXPECT_DOUBLE_EQ(vector[1].coordinates[0], -4.5);
+}
+
+// Test that the parsed numbers round like strtod, on both the fast and the slow path
+TEST_F(CSVUtilsTest, ParsesNumbersLikeStrtod)
+{
+    for (const char *text : {"0", "-0.0", "3.14159", "1e22", "1e23", "-2.5e-10", "0.000123456789",
+                             "0.1234567890123456789012", "123456789012345678901234", "9007199254740993",
+                             "1.7976931348623157e308", "4.9e-324", "+12.5E+3"})
+    {
+        const char *cursor = text;
+        const char *end = text + std::strlen(text);
+        double value;
+        ASSERT_TRUE(CSVUtils::parseNumber(cursor, end, value)) << text;
+        EXPECT_EQ(cursor, end) << text;
+        EXPECT_EQ(value, std::strtod(text, nullptr)) << text;
+    }
+
+    for (const char *text : {"", "x", "1.2.3", "--1", "1e", "."})
+    {
+        const char *cursor = text;
+        double value;
+        EXPECT_FALSE(CSVUtils::parseNumber(cursor, text + std::strlen(text), value)) << text;
+    }
+}
+
+// Test that rows with a wrong number of columns or non-numeric data are rejected
+TEST_F(CSVUtilsTest, RejectsInvalidRows)
+{
+    write("1,2\n3,4,5\n");
+    EXPECT_THROW((CSVUtils::readPointSet<double, 2>(path.string())), std::runtime_error);
+
+    write("1,2\n3,a\n");
+    EXPECT_THROW((CSVUtils::readPointSet<double, 2>(path.string())), std::runtime_error);
+
+    EXPECT_THROW((CSVUtils::readPointSet<double, 2>((path.string() + ".missing"))), std::runtime_error);
+}
+
+// Test that a file larger than a chunk is split at line boundaries
+TEST_F(CSVUtilsTest, ReadsLargeFileInChunks)
+{
+    const std::size_t numRows = 50000;
+    std::string content = "x,y\n";
+    for (std::size_t i = 0; i < numRows; ++i)
+    {
+        content += std::to_string(i) + "," + std::to_string(i) + ".5\n";
+    }
+    write(content);
+
+    PointSet<double, 2> points = CSVUtils::readPointSet<double, 2>(path.string());
+    ASSERT_EQ(points.size(), numRows);
+    for (std::size_t i = 0; i < numRows; ++i)
+    {
+        ASSERT_EQ(points(i, 0), static_cast<double>(i));
+        ASSERT_EQ(points(i, 1), i + 0.5);
+    }
+}
+
+// Test that the batch source streams the rows and restarts after a rewind
+TEST_F(CSVUtilsTest, StreamsBatches)
+{
+    write("x,y\n0,0\n1,10\n2,20\n\n3,30\n4,40\n");
+    CSVBatchSource<double, 2> source(path.string());
+    PointSet<double, 2> batch;
+
+    EXPECT_EQ(source.nextBatch(2, batch), 2u);
+    EXPECT_DOUBLE_EQ(batch(1, 1), 10.0);
+    EXPECT_EQ(source.nextBatch(2, batch), 2u);
+    EXPECT_DOUBLE_EQ(batch(0, 0), 2.0);
+    EXPECT_DOUBLE_EQ(batch(1, 0), 3.0);
+    EXPECT_EQ(source.nextBatch(2, batch), 1u);
+    EXPECT_EQ(batch.size(), 1u);
+    EXPECT_EQ(source.nextBatch(2, batch), 0u);
+
+    source.rewind();
+    EXPECT_EQ(source.nextBatch(10, batch), 5u);
+    EXPECT_DOUBLE_EQ(batch(4, 1), 40.0);
+}
+
+// Test that the binary cache is written on the first read and only reused for the same source and dimension
+TEST_F(CSVUtilsTest, CachesPointSet)
+{
+    write("x,y\n1,2\n3,4\n");
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+    const std::filesystem::path cachePath = BinaryCache::cachePath(path, PointSetCache::EXTENSION);
+
+    PointSet<double, 2> parsed = CSVUtils::readPointSetCached<double, 2>(path.string());
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+
+    PointSet<double, 2> cached;
+    BinaryCache::SourceStamp stamp;
+    ASSERT_TRUE(BinaryCache::stamp(path, stamp));
+    ASSERT_TRUE(PointSetCache::load(cachePath, cached, &stamp));
+    ASSERT_EQ(cached.size(), 2u);
+    EXPECT_EQ(cached(1, 0), 3.0);
+    EXPECT_EQ(cached(1, 1), 4.0);
+    EXPECT_EQ(cached.getLabel(0), (PointSet<double, 2>::UNASSIGNED));
+
+    // Another dimension does not match the cache
+    PointSet<double, 3> points3D;
+    EXPECT_FALSE(PointSetCache::load(cachePath, points3D));
+
+    // A changed source is parsed again
+    write("x,y\n5,6\n");
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - std::chrono::minutes(30));
+    PointSet<double, 2> changed = CSVUtils::readPointSetCached<double, 2>(path.string());
+    ASSERT_EQ(changed.size(), 1u);
+    EXPECT_EQ(changed(0, 1), 6.0);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <algorithm>
+#include "utils/RadixHeap.hpp"
+
+// Test that the elements are popped in increasing order of key
+TEST(RadixHeapTest, PopsInKeyOrder)
+{
+    RadixHeap<int> heap;
+    std::vector<double> keys = {3.5, 0.0, 12.25, 1e-9, 7.0, 3.5};
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        heap.push(keys[i], static_cast<int>(i));
+    }
+    ASSERT_EQ(heap.size(), keys.size());
+
+    std::sort(keys.begin(), keys.end());
+    for (double key : keys)
+    {
+        auto [poppedKey, value] = heap.pop();
+        EXPECT_EQ(poppedKey, key);
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
+// Test a Dijkstra-like sequence, where the pushed keys are never below the last popped one
+TEST(RadixHeapTest, HandlesMonotonePushes)
+{
+    RadixHeap<int> heap;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> weight(0.0, 2.0);
+
+    heap.push(0.0, 0);
+    double lastKey = 0.0;
+    int pushed = 1;
+    while (!heap.empty())
+    {
+        auto [key, value] = heap.pop();
+        EXPECT_GE(key, lastKey);
+        lastKey = key;
+        for (int i = 0; i < 3 && pushed < 2000; ++i, ++pushed)
+        {
+            heap.push(key + weight(rng), pushed);
+        }
+    }
+    EXPECT_EQ(pushed, 2000);
+}
+
+// Test that a cleared heap can be reused from key zero
+TEST(RadixHeapTest, ClearResetsTheHeap)
+{
+    RadixHeap<int> heap;
+    heap.push(5.0, 1);
+    heap.pop();
+    heap.push(8.0, 2);
+    heap.clear();
+    EXPECT_TRUE(heap.empty());
+
+    heap.push(1.0, 3);
+    heap.push(0.5, 4);
+    EXPECT_EQ(heap.pop().second, 4);
+    EXPECT_EQ(heap.pop().second, 3);
+}